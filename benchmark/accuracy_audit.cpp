@@ -0,0 +1,354 @@
+#include "trigonometry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+    using reference_type = long double;
+
+    constexpr std::size_t chunk_size = 1 << 14;
+
+    struct audit_settings
+    {
+        std::uint64_t float_stride = 1;
+        std::uint64_t double_samples = std::uint64_t(1) << 24;
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    };
+
+    template<typename real>
+    using bits_type = std::conditional_t<sizeof(real) == sizeof(std::uint32_t), std::uint32_t, std::uint64_t>;
+
+    template<typename real>
+    const char* type_name()
+    {
+        return sizeof(real) == sizeof(float) ? "float" : "double";
+    }
+
+    /// \brief maps real to integer with same order, neighbouring reals map to neighbouring integers
+    /// -0 and +0 both map to 0
+    template<typename real>
+    std::int64_t to_ordered(real x)
+    {
+        constexpr bits_type<real> sign_mask = bits_type<real>(1) << (sizeof(real) * 8 - 1);
+        const bits_type<real> bits = std::bit_cast<bits_type<real>>(x);
+        const std::int64_t magnitude = static_cast<std::int64_t>(bits & ~sign_mask);
+        return (bits & sign_mask) ? -magnitude : magnitude;
+    }
+
+    template<typename real>
+    real from_ordered(std::int64_t ordered)
+    {
+        constexpr bits_type<real> sign_mask = bits_type<real>(1) << (sizeof(real) * 8 - 1);
+        const bits_type<real> bits = ordered < 0
+            ? static_cast<bits_type<real>>(-ordered) | sign_mask
+            : static_cast<bits_type<real>>(ordered);
+        return std::bit_cast<real>(bits);
+    }
+
+    /// \brief unit in last place of 'real' at value, subnormal spacing below smallest normal
+    template<typename real>
+    reference_type ulp(reference_type value)
+    {
+        const reference_type magnitude = std::fabs(value);
+        if (magnitude < std::numeric_limits<real>::min())
+            return std::numeric_limits<real>::denorm_min();
+        return std::ldexp(reference_type(1), std::ilogb(magnitude) - (std::numeric_limits<real>::digits - 1));
+    }
+
+    /// \brief error maxima of one function and polynomial size together with arguments reaching them
+    template<typename real>
+    struct error_statistics
+    {
+        std::uint64_t samples = 0;
+        std::uint64_t non_finite = 0;
+        reference_type max_ulp = 0;
+        reference_type max_abs = 0;
+        reference_type max_rel = 0;
+        real worst_ulp_argument = 0;
+        real worst_abs_argument = 0;
+        real worst_rel_argument = 0;
+
+        void add(real argument, real result, reference_type reference)
+        {
+            ++samples;
+            if (!std::isfinite(result))
+            {
+                ++non_finite;
+                return;
+            }
+
+            const reference_type abs_error = std::fabs(static_cast<reference_type>(result) - reference);
+            const reference_type ulp_error = abs_error / ulp<real>(reference);
+            if (ulp_error > max_ulp)
+            {
+                max_ulp = ulp_error;
+                worst_ulp_argument = argument;
+            }
+            if (abs_error > max_abs)
+            {
+                max_abs = abs_error;
+                worst_abs_argument = argument;
+            }
+            if (reference != 0 && abs_error / std::fabs(reference) > max_rel)
+            {
+                max_rel = abs_error / std::fabs(reference);
+                worst_rel_argument = argument;
+            }
+        }
+
+        void merge(const error_statistics& other)
+        {
+            samples += other.samples;
+            non_finite += other.non_finite;
+            if (other.max_ulp > max_ulp)
+            {
+                max_ulp = other.max_ulp;
+                worst_ulp_argument = other.worst_ulp_argument;
+            }
+            if (other.max_abs > max_abs)
+            {
+                max_abs = other.max_abs;
+                worst_abs_argument = other.worst_abs_argument;
+            }
+            if (other.max_rel > max_rel)
+            {
+                max_rel = other.max_rel;
+                worst_rel_argument = other.worst_rel_argument;
+            }
+        }
+    };
+
+    template<typename real>
+    struct audit_result
+    {
+        std::string function;
+        std::size_t polynomial_size;
+        error_statistics<real> errors;
+    };
+
+    /// \brief sweeps ordered arguments in [i_min, i_max] with given stride on all threads
+    /// reference is computed once per argument and shared by every polynomial size,
+    /// sizes are evaluated through batch api, so the audited code is the simd path.
+    /// \param i_reference: reference_type(reference_type)
+    /// \param i_batch: generic lambda, template operator()<size>(span<const real>, span<real>)
+    template<typename real, std::size_t... sizes, typename reference_function, typename batch_function>
+    void audit_function(const std::string& i_name, real i_min, real i_max, std::uint64_t i_stride, unsigned i_threads,
+        const reference_function& i_reference, const batch_function& i_batch, std::vector<audit_result<real>>& o_results)
+    {
+        constexpr std::size_t size_count = sizeof...(sizes);
+        constexpr std::size_t size_values[] = {sizes...};
+
+        const std::int64_t first = to_ordered(i_min);
+        const std::uint64_t count = static_cast<std::uint64_t>(to_ordered(i_max) - first) / i_stride + 1;
+        const std::uint64_t chunk_count = (count + chunk_size - 1) / chunk_size;
+
+        std::atomic<std::uint64_t> next_chunk{0};
+        std::mutex merge_mutex;
+        std::vector<error_statistics<real>> total(size_count);
+
+        const auto worker = [&]
+        {
+            std::vector<error_statistics<real>> local(size_count);
+            std::vector<real> arguments(chunk_size);
+            std::vector<reference_type> references(chunk_size);
+            std::vector<real> results(chunk_size);
+
+            for (std::uint64_t chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++)
+            {
+                const std::uint64_t begin = chunk * chunk_size;
+                const std::size_t length = static_cast<std::size_t>(std::min<std::uint64_t>(chunk_size, count - begin));
+                for (std::size_t i = 0; i < length; ++i)
+                {
+                    arguments[i] = from_ordered<real>(first + static_cast<std::int64_t>((begin + i) * i_stride));
+                    references[i] = i_reference(static_cast<reference_type>(arguments[i]));
+                }
+
+                const std::span<const real> argument_span(arguments.data(), length);
+                const std::span<real> result_span(results.data(), length);
+                std::size_t size_index = 0;
+                ((i_batch.template operator()<sizes>(argument_span, result_span),
+                    [&] {
+                        for (std::size_t i = 0; i < length; ++i)
+                            local[size_index].add(arguments[i], results[i], references[i]);
+                        ++size_index;
+                    }()), ...);
+            }
+
+            std::lock_guard<std::mutex> lock(merge_mutex);
+            for (std::size_t s = 0; s < size_count; ++s)
+                total[s].merge(local[s]);
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned t = 1; t < i_threads; ++t)
+            threads.emplace_back(worker);
+        worker();
+        for (auto& thread : threads)
+            thread.join();
+
+        for (std::size_t s = 0; s < size_count; ++s)
+            o_results.push_back(audit_result<real>{i_name, size_values[s], total[s]});
+        std::cout<<type_name<real>()<<" "<<i_name<<": "<<count<<" arguments"<<std::endl;
+    }
+
+    template<typename real, std::size_t... sizes>
+    void audit_functions(std::uint64_t i_stride, unsigned i_threads, std::vector<audit_result<real>>& o_results)
+    {
+        constexpr real max = std::numeric_limits<real>::max();
+
+        audit_function<real, sizes...>("sin", -max, max, i_stride, i_threads,
+            [](reference_type x){ return std::sin(x); },
+            []<std::size_t size>(std::span<const real> x, std::span<real> r){ trigonometry<real, size>::sin(x, r); }, o_results);
+        audit_function<real, sizes...>("cos", -max, max, i_stride, i_threads,
+            [](reference_type x){ return std::cos(x); },
+            []<std::size_t size>(std::span<const real> x, std::span<real> r){ trigonometry<real, size>::cos(x, r); }, o_results);
+        audit_function<real, sizes...>("tan", -max, max, i_stride, i_threads,
+            [](reference_type x){ return std::tan(x); },
+            []<std::size_t size>(std::span<const real> x, std::span<real> r){ trigonometry<real, size>::tan(x, r); }, o_results);
+        audit_function<real, sizes...>("asin", -1, 1, i_stride, i_threads,
+            [](reference_type x){ return std::asin(x); },
+            []<std::size_t size>(std::span<const real> x, std::span<real> r){ trigonometry<real, size>::asin(x, r); }, o_results);
+        audit_function<real, sizes...>("atan", -max, max, i_stride, i_threads,
+            [](reference_type x){ return std::atan(x); },
+            []<std::size_t size>(std::span<const real> x, std::span<real> r){ trigonometry<real, size>::atan(x, r); }, o_results);
+        // atan2(y, 1) reaches both octant branches: |y| <= 1 directly, |y| > 1 swapped
+        audit_function<real, sizes...>("atan2", -max, max, i_stride, i_threads,
+            [](reference_type y){ return std::atan2(y, reference_type(1)); },
+            []<std::size_t size>(std::span<const real> y, std::span<real> r)
+            {
+                thread_local std::vector<real> rcos;
+                rcos.assign(y.size(), real(1));
+                trigonometry<real, size>::atan2(y, rcos, r);
+            }, o_results);
+    }
+
+    /// \brief stride of ordered arguments giving about 'samples' arguments over all finite values
+    template<typename real>
+    std::uint64_t stride_for_samples(std::uint64_t samples)
+    {
+        const std::uint64_t range = static_cast<std::uint64_t>(to_ordered(std::numeric_limits<real>::max())) * 2;
+        return std::max<std::uint64_t>(1, range / std::max<std::uint64_t>(1, samples));
+    }
+
+    template<typename real>
+    void print(const std::vector<audit_result<real>>& i_results)
+    {
+        std::cout<<std::left<<std::setw(8)<<"type"<<std::setw(8)<<"function"<<std::setw(6)<<"size"<<std::right
+            <<std::setw(14)<<"max ulp"<<std::setw(14)<<"worst x"<<std::setw(14)<<"max abs"<<std::setw(14)<<"worst x"
+            <<std::setw(14)<<"max rel"<<std::setw(12)<<"non finite"<<std::endl;
+        for (const auto& r : i_results)
+        {
+            std::cout<<std::left<<std::setw(8)<<type_name<real>()<<std::setw(8)<<r.function<<std::setw(6)<<r.polynomial_size<<std::right
+                <<std::setprecision(4)<<std::setw(14)<<static_cast<double>(r.errors.max_ulp)<<std::setw(14)<<r.errors.worst_ulp_argument
+                <<std::setw(14)<<static_cast<double>(r.errors.max_abs)<<std::setw(14)<<r.errors.worst_abs_argument
+                <<std::setw(14)<<static_cast<double>(r.errors.max_rel)<<std::setw(12)<<r.errors.non_finite<<std::endl;
+        }
+    }
+
+    template<typename real>
+    void write_csv(const std::vector<audit_result<real>>& i_results, std::ostream& o_stream)
+    {
+        o_stream<<std::setprecision(std::numeric_limits<real>::max_digits10);
+        for (const auto& r : i_results)
+        {
+            o_stream<<type_name<real>()<<","<<r.function<<","<<r.polynomial_size<<","<<r.errors.samples<<","<<r.errors.non_finite<<","
+                <<static_cast<double>(r.errors.max_ulp)<<","<<r.errors.worst_ulp_argument<<","
+                <<static_cast<double>(r.errors.max_abs)<<","<<r.errors.worst_abs_argument<<","
+                <<static_cast<double>(r.errors.max_rel)<<","<<r.errors.worst_rel_argument<<std::endl;
+        }
+    }
+
+    /// \brief smallest audited polynomial size whose max abs error is at most epsilon, per function
+    /// functions without non finite results only, 0 when no audited size is accurate enough
+    template<typename real>
+    void write_degree_table(const std::vector<audit_result<real>>& i_results, std::ostream& o_stream)
+    {
+        const int smallest_exponent = -std::numeric_limits<real>::digits10 - 1;
+        std::vector<std::string> functions;
+        for (const auto& r : i_results)
+        {
+            if (std::find(functions.begin(), functions.end(), r.function) == functions.end())
+                functions.push_back(r.function);
+        }
+
+        for (int exponent = -2; exponent >= smallest_exponent; --exponent)
+        {
+            const reference_type epsilon = std::pow(reference_type(10), exponent);
+            for (const auto& function : functions)
+            {
+                std::size_t needed = 0;
+                for (const auto& r : i_results)
+                {
+                    if (r.function == function && r.errors.non_finite == 0 && r.errors.max_abs <= epsilon
+                        && (needed == 0 || r.polynomial_size < needed))
+                        needed = r.polynomial_size;
+                }
+                o_stream<<type_name<real>()<<",1e"<<exponent<<","<<function<<","<<needed<<std::endl;
+            }
+        }
+    }
+
+    audit_settings parse_arguments(int argc, char** argv)
+    {
+        audit_settings settings;
+        for (int a = 1; a + 1 < argc; a += 2)
+        {
+            const std::string name = argv[a];
+            const std::uint64_t value = std::stoull(argv[a + 1]);
+            if (name == "--float-stride")
+                settings.float_stride = std::max<std::uint64_t>(1, value);
+            else if (name == "--double-samples")
+                settings.double_samples = value;
+            else if (name == "--threads")
+                settings.threads = std::max<unsigned>(1, static_cast<unsigned>(value));
+            else
+                std::cerr<<"unknown option "<<name<<std::endl;
+        }
+        return settings;
+    }
+}
+
+/// \brief accuracy audit of polynomial trigonometry against long double libm
+/// float: every finite float in function domain (--float-stride N takes every N-th),
+/// double: about --double-samples arguments evenly spread over ordered bit patterns.
+/// writes accuracy_audit.csv and accuracy_degree.csv into working directory
+int main(int argc, char** argv)
+{
+    const audit_settings settings = parse_arguments(argc, argv);
+    std::cout<<"threads: "<<settings.threads<<std::endl;
+
+    std::vector<audit_result<float>> float_results;
+    audit_functions<float, 3, 4, 5, 6, 7, 8>(settings.float_stride, settings.threads, float_results);
+
+    std::vector<audit_result<double>> double_results;
+    audit_functions<double, 6, 7, 8, 9, 10, 11, 12>(stride_for_samples<double>(settings.double_samples), settings.threads, double_results);
+
+    print(float_results);
+    print(double_results);
+
+    std::ofstream audit("accuracy_audit.csv");
+    audit<<"type,function,polynomial_size,samples,non_finite,max_ulp,worst_ulp_argument,max_abs,worst_abs_argument,max_rel,worst_rel_argument"<<std::endl;
+    write_csv(float_results, audit);
+    write_csv(double_results, audit);
+
+    std::ofstream degree("accuracy_degree.csv");
+    degree<<"type,epsilon,function,polynomial_size"<<std::endl;
+    write_degree_table(float_results, degree);
+    write_degree_table(double_results, degree);
+
+    return 0;
+}
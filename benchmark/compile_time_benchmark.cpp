@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct compile_settings
+    {
+        std::size_t repetitions = 5;
+        std::size_t max_size = 24;
+        bool count_operations = true;
+    };
+
+    struct compile_result
+    {
+        std::string function;
+        std::string type;
+        std::size_t polynomial_size;
+        double seconds;
+        std::uint64_t constexpr_operations;
+    };
+
+    std::string compile_command(const std::string& i_definitions, const std::string& i_extra)
+    {
+        return std::string(TRIGONOMETRY_CXX_COMPILER) + " -std=c++20 -fsyntax-only -I" + TRIGONOMETRY_SOURCE_DIR + "/../include "
+            + i_definitions + " " + i_extra + " " + TRIGONOMETRY_SOURCE_DIR + "/compile_time_table.cpp > /dev/null 2>&1";
+    }
+
+    bool compiles(const std::string& i_definitions, const std::string& i_extra = "")
+    {
+        return std::system(compile_command(i_definitions, i_extra).c_str()) == 0;
+    }
+
+    /// \brief median wall time of compiling the translation unit
+    double compile_seconds(const std::string& i_definitions, std::size_t i_repetitions)
+    {
+        std::vector<double> seconds;
+        for (std::size_t r = 0; r < i_repetitions; ++r)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            compiles(i_definitions);
+            seconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(seconds.begin(), seconds.end());
+        return seconds[seconds.size() / 2];
+    }
+
+    /// \brief operations of the largest constant evaluation: smallest -fconstexpr-ops-limit
+    /// that still compiles, found by bisection within 2%
+    std::uint64_t constexpr_operations(const std::string& i_definitions)
+    {
+        std::uint64_t low = 1 << 10;
+        std::uint64_t high = std::uint64_t(1) << 36;
+        while (high - low > high / 50)
+        {
+            const std::uint64_t middle = low + (high - low) / 2;
+            if (compiles(i_definitions, "-fconstexpr-ops-limit=" + std::to_string(middle)))
+                high = middle;
+            else
+                low = middle;
+        }
+        return high;
+    }
+
+    void measure_tables(const char* i_type, const compile_settings& i_settings, std::vector<compile_result>& o_results)
+    {
+        const std::string headers = std::string("-DTABLE_TYPE=") + i_type;
+        const double header_seconds = compile_seconds(headers, i_settings.repetitions);
+
+        for (const char* function : {"sin", "cos", "atan", "asin"})
+        {
+            for (std::size_t size = 4; size <= i_settings.max_size; size += 4)
+            {
+                const std::string definitions = headers + " -DTABLE_FUNCTION=" + function + " -DTABLE_SIZE=" + std::to_string(size);
+                compile_result result{function, i_type, size, 0, 0};
+                result.seconds = compile_seconds(definitions, i_settings.repetitions) - header_seconds;
+                if (i_settings.count_operations)
+                    result.constexpr_operations = constexpr_operations(definitions);
+                o_results.push_back(result);
+                std::cout<<std::left<<std::setw(10)<<result.function<<std::setw(8)<<result.type<<std::setw(6)<<result.polynomial_size
+                    <<std::right<<std::fixed<<std::setprecision(3)<<std::setw(10)<<result.seconds
+                    <<std::setw(14)<<result.constexpr_operations<<std::defaultfloat<<std::endl;
+            }
+        }
+    }
+
+    compile_settings parse_arguments(int argc, char** argv)
+    {
+        compile_settings settings;
+        for (int a = 1; a + 1 < argc; a += 2)
+        {
+            const std::string name = argv[a];
+            const std::uint64_t value = std::stoull(argv[a + 1]);
+            if (name == "--repetitions")
+                settings.repetitions = std::max<std::uint64_t>(1, value);
+            else if (name == "--max-size")
+                settings.max_size = value;
+            else if (name == "--count-operations")
+                settings.count_operations = value != 0;
+            else
+                std::cerr<<"unknown option "<<name<<std::endl;
+        }
+        return settings;
+    }
+}
+
+/// \brief compile time budget of coefficient tables
+/// compiles one table per function, type and polynomial size with the compiler this benchmark
+/// was built with: seconds above parsing headers alone (median of --repetitions) and
+/// constexpr operations of the table (GCC -fconstexpr-ops-limit, --count-operations 0 skips).
+/// writes compile_time.csv into working directory
+int main(int argc, char** argv)
+{
+    const compile_settings settings = parse_arguments(argc, argv);
+    if (!compiles("-DTABLE_TYPE=float"))
+    {
+        std::cerr<<"cannot compile "<<TRIGONOMETRY_SOURCE_DIR<<"/compile_time_table.cpp with "<<TRIGONOMETRY_CXX_COMPILER<<std::endl;
+        return 1;
+    }
+
+    std::cout<<std::left<<std::setw(10)<<"function"<<std::setw(8)<<"type"<<std::setw(6)<<"size"
+        <<std::right<<std::setw(10)<<"seconds"<<std::setw(14)<<"constexpr ops"<<std::endl;
+    std::vector<compile_result> results;
+    measure_tables("float", settings, results);
+    measure_tables("double", settings, results);
+
+    std::ofstream csv("compile_time.csv");
+    csv<<"function,type,polynomial_size,seconds,constexpr_operations"<<std::endl;
+    for (const auto& r : results)
+        csv<<r.function<<","<<r.type<<","<<r.polynomial_size<<","<<r.seconds<<","<<r.constexpr_operations<<std::endl;
+
+    return 0;
+}
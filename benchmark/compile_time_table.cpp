@@ -0,0 +1,12 @@
+// translation unit compiled by compile_time_benchmark, not part of any target
+// -DTABLE_FUNCTION=sin|cos|atan|asin -DTABLE_TYPE=float|double -DTABLE_SIZE=N builds one table,
+// without TABLE_FUNCTION only headers are parsed
+#include "trigonometry.h"
+
+#if defined(TABLE_FUNCTION)
+#define TRIGONOMETRY_TABLE_CREATE(function) TRIGONOMETRY_TABLE_CREATE_NAME(function)
+#define TRIGONOMETRY_TABLE_CREATE_NAME(function) _math_detail::create_##function##_polynomial
+
+constexpr auto table = TRIGONOMETRY_TABLE_CREATE(TABLE_FUNCTION)<TABLE_TYPE, TABLE_SIZE>();
+static_assert(table.getCoefficients()[0] == table.getCoefficients()[0], "table is not finite");
+#endif
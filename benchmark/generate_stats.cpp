@@ -1,13 +1,20 @@
+#include "piecewise_polynomial.h"
+#include "piecewise_trigonometry.h"
 #include "polynomial.h"
 #include "trigonometry.h"
+#include <algorithm>
 #include <cmath>
 #include <functional>
 #include <chrono>
 #include <fstream>
 #include <iomanip>
+#include <iostream>
 #include <string>
+#include <thread>
 #include <map>
-#include <stdlib.h>
+#include <memory>
+#include <span>
+#include <vector>
 
 template<typename real>
 using unary_function = std::function<real(real)>;
@@ -53,66 +60,202 @@ void compare_functions_output(unary_function<real> i_func1,
 }
 
 
-template <typename real>
-void compare_functions_performance(std::vector<std::pair<unary_function<real>, unary_function<real>>> i_functions, 
-    std::vector<std::pair<real, real>> i_domains, 
-    std::vector<std::string> i_names,
-    std::pair<std::string, std::string> i_suffixes)
+template<typename real, std::size_t size>
+void compare_sincos_performance()
 {
+    using math = trigonometry<real, size>;
     constexpr std::size_t num_calls = 10000000;
 
-    std::vector<std::pair<std::size_t, std::size_t>> performance(i_functions.size(), std::make_pair(0, 0));
-    for(std::size_t i = 0; i < i_functions.size(); ++i)
+    std::vector<real> params(num_calls), sin_results(num_calls), cos_results(num_calls);
+    const real step = static_cast<real>(M_PI*8) / (num_calls-1);
+    for(std::size_t c = 0; c < num_calls; ++c)
+        params[c] = static_cast<real>(-M_PI*4) + step*c;
+
+    using std::chrono::steady_clock;
+    const auto elapsed_ns = [](steady_clock::time_point start, steady_clock::time_point end)
     {
-        const auto& [func1, func2] = i_functions[i];
-        const auto [domain_min, domain_max] = i_domains[i];
-        const auto step = (domain_max - domain_min) / (num_calls-1);
+        return std::chrono::duration<double, std::nano>(end - start).count() / num_calls;
+    };
 
-        using std::chrono::steady_clock;
+    const auto separate_start = steady_clock::now();
+    for(std::size_t c = 0; c < num_calls; ++c)
+    {
+        sin_results[c] = math::sin(params[c]);
+        cos_results[c] = math::cos(params[c]);
+    }
+    const auto fused_start = steady_clock::now();
+    for(std::size_t c = 0; c < num_calls; ++c)
+        math::sincos(params[c], &sin_results[c], &cos_results[c]);
+    const auto batch_separate_start = steady_clock::now();
+    math::sin(params, sin_results);
+    math::cos(params, cos_results);
+    const auto batch_fused_start = steady_clock::now();
+    math::sincos(params, sin_results, cos_results);
+    const auto batch_fused_end = steady_clock::now();
+    // same progression by rotation recurrence, without parameter array
+    phase_sequence<real, size> sequence(static_cast<real>(-M_PI*4), step);
+    sequence.generate(sin_results, cos_results);
+    const auto sequence_end = steady_clock::now();
 
-        const auto func1_start = steady_clock::now();
-        for(std::size_t c = 0; c < num_calls; ++c)
-        {
-            const real param = domain_min + step*c;
-            const real result = func1(param);
-            static_cast<void>(result);
-        }
-        const auto func2_start = steady_clock::now();
-        for(std::size_t c = 0; c < num_calls; ++c)
-        {
-            const real param = domain_min + step*c;
-            const real result = func2(param);
-            static_cast<void>(result);
-        }
-        const auto func2_end = steady_clock::now();
+    std::ofstream report("sincos_performance.dat");
+    report<<"#mode\tsin+cos(ns)\tsincos(ns)"<<std::endl;
+    report<<"scalar\t"<<elapsed_ns(separate_start, fused_start)<<"\t"<<elapsed_ns(fused_start, batch_separate_start)<<std::endl;
+    report<<"batch\t"<<elapsed_ns(batch_separate_start, batch_fused_start)<<"\t"<<elapsed_ns(batch_fused_start, batch_fused_end)<<std::endl;
+    report<<"sequence\t-\t"<<elapsed_ns(batch_fused_end, sequence_end)<<std::endl;
+}
+
+template<typename real, typename function_type, typename reference_type>
+void measure_approximation(const std::string& i_name, const function_type& i_func, const reference_type& i_reference,
+    std::pair<real, real> i_domain, std::ostream& o_report)
+{
+    constexpr std::size_t num_calls = 10000000;
+    constexpr std::size_t num_samples = 100000;
 
-        const auto func1_ms = std::chrono::duration_cast<std::chrono::milliseconds>(func2_start - func1_start);
-        const auto func2_ms = std::chrono::duration_cast<std::chrono::milliseconds>(func2_end - func2_start);
-        performance[i] = std::make_pair(func1_ms.count(), func2_ms.count());
+    double max_error = 0;
+    const real step = (i_domain.second - i_domain.first) / (num_samples-1);
+    for(std::size_t c = 0; c < num_samples; ++c)
+    {
+        const real x = i_domain.first + step*c;
+        max_error = std::max(max_error, std::abs(static_cast<double>(i_func(x)) - i_reference(x)));
     }
-    { // performance data
-        std::ofstream performance_dat("performance.dat");
-        for(std::size_t i = 0; i < performance.size(); ++i)
+
+    // every evaluation depends on previous result, halving keeps parameter in domain
+    using std::chrono::steady_clock;
+    real chained = 0;
+    const auto start = steady_clock::now();
+    for(std::size_t c = 0; c < num_calls; ++c)
+        chained = i_func(chained) * static_cast<real>(0.5);
+    const auto end = steady_clock::now();
+    volatile real sink = chained;
+    static_cast<void>(sink);
+
+    const double latency_ns = std::chrono::duration<double, std::nano>(end - start).count() / num_calls;
+    o_report<<i_name<<"\t"<<latency_ns<<"\t"<<max_error<<std::endl;
+}
+
+template<typename real>
+void compare_piecewise_polynomials()
+{
+    const auto cos_reference = [](long double u){ return _math_detail::cos_sqrt_reference(u); };
+    const auto asin_reference = [](long double x){ return std::asin(x); };
+    const std::pair<real, real> cos_domain(0, static_cast<real>(M_PI*M_PI/16));
+    const std::pair<real, real> asin_domain(-1, 1);
+
+    constexpr polynomial<real, 8> cos_global = _math_detail::create_cos_polynomial<real, 8>();
+    constexpr auto cos_piecewise = piecewise_polynomial<real, 2, 16>::interpolate(cos_reference, 0, static_cast<real>(M_PI*M_PI/16));
+    constexpr auto& asin_global = _math_detail::asin_polynomial<real, 8, polynomial_evaluation::horner>;
+    constexpr auto asin_piecewise = piecewise_polynomial<real, 3, 64>::interpolate(asin_reference, -1, 1);
+
+    std::ofstream report("piecewise_performance.dat");
+    report<<"#approximation\tlatency(ns)\tmax_error"<<std::endl;
+    measure_approximation<real>("cos_global_8", [&](real u){ return cos_global(u); }, [](double u){ return std::cos(std::sqrt(u)); }, cos_domain, report);
+    measure_approximation<real>("cos_piecewise_2x16", [&](real u){ return cos_piecewise(u); }, [](double u){ return std::cos(std::sqrt(u)); }, cos_domain, report);
+    measure_approximation<real>("asin_global_8", [&](real x){ return asin_global(x); }, [](double x){ return std::asin(x); }, asin_domain, report);
+    measure_approximation<real>("asin_piecewise_3x64", [&](real x){ return asin_piecewise(x); }, [](double x){ return std::asin(x); }, asin_domain, report);
+    measure_approximation<real>("asin_folded_3x64", [](real x){ return piecewise_trigonometry<real, 3, 64>::asin(x); }, [](double x){ return std::asin(x); }, asin_domain, report);
+}
+
+template<typename real, std::size_t size, typename evaluation_policy>
+void measure_evaluation_policy(const std::string& i_policy_name, const std::vector<real>& i_params, std::ostream& o_report)
+{
+    constexpr polynomial<real, size, evaluation_policy> poly(_math_detail::create_cos_polynomial<real, size>().getCoefficients());
+
+    using std::chrono::steady_clock;
+
+    // latency: every evaluation depends on previous result,
+    // octant cos kernel stays in [cos(pi/4), 1], halving keeps parameter in fitted domain
+    real chained = 0;
+    const auto latency_start = steady_clock::now();
+    for(std::size_t c = 0; c < i_params.size(); ++c)
+        chained = poly(chained) * static_cast<real>(0.5);
+    const auto latency_end = steady_clock::now();
+
+    // throughput: independent evaluations
+    std::vector<real> results(i_params.size());
+    const auto throughput_start = steady_clock::now();
+    for(std::size_t c = 0; c < i_params.size(); ++c)
+        results[c] = poly(i_params[c]);
+    const auto throughput_end = steady_clock::now();
+
+    volatile real sink = chained + results[results.size() / 2];
+    static_cast<void>(sink);
+
+    const double latency_ns = std::chrono::duration<double, std::nano>(latency_end - latency_start).count() / i_params.size();
+    const double throughput_ns = std::chrono::duration<double, std::nano>(throughput_end - throughput_start).count() / i_params.size();
+    o_report<<size<<"\t"<<i_policy_name<<"\t"<<latency_ns<<"\t"<<throughput_ns<<std::endl;
+}
+
+template<typename real, std::size_t size>
+void measure_evaluation_policies(const std::vector<real>& i_params, std::ostream& o_report)
+{
+    measure_evaluation_policy<real, size, polynomial_evaluation::power_sum>("power_sum", i_params, o_report);
+    measure_evaluation_policy<real, size, polynomial_evaluation::horner>("horner", i_params, o_report);
+    measure_evaluation_policy<real, size, polynomial_evaluation::estrin>("estrin", i_params, o_report);
+    measure_evaluation_policy<real, size, polynomial_evaluation::even_odd>("even_odd", i_params, o_report);
+}
+
+template<typename real>
+void compare_evaluation_policies()
+{
+    constexpr std::size_t num_calls = 10000000;
+
+    std::vector<real> params(num_calls);
+    const real step = static_cast<real>(M_PI*M_PI/16) / (num_calls-1);
+    for(std::size_t c = 0; c < num_calls; ++c)
+        params[c] = step*c;
+
+    std::ofstream report("evaluation_policies.dat");
+    report<<"#size\tpolicy\tlatency(ns)\tthroughput(ns)"<<std::endl;
+    measure_evaluation_policies<real, 4>(params, report);
+    measure_evaluation_policies<real, 8>(params, report);
+    measure_evaluation_policies<real, 12>(params, report);
+    measure_evaluation_policies<real, 16>(params, report);
+}
+
+/// \brief batch sin over large array on 1, 2, 4, ... threads up to hardware concurrency
+/// arrays are first touched by measured pool, so page faults stay out of measured loops
+template<typename real, std::size_t size>
+void compare_parallel_scaling()
+{
+    using math = trigonometry<real, size>;
+    constexpr std::size_t num_elements = std::size_t(1) << 26;
+    constexpr std::size_t num_repetitions = 5;
+    const unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<unsigned> thread_counts;
+    for(unsigned threads = 1; threads < max_threads; threads *= 2)
+        thread_counts.push_back(threads);
+    thread_counts.push_back(max_threads);
+
+    std::ofstream report("parallel_scaling.dat");
+    report<<"#threads\tns/element\tspeedup"<<std::endl;
+    double single_thread_ns = 0;
+    for(const unsigned threads : thread_counts)
+    {
+        parallel::thread_pool pool(threads);
+        std::unique_ptr<real[]> params_storage(new real[num_elements]);
+        std::unique_ptr<real[]> results_storage(new real[num_elements]);
+        const std::span<real> params(params_storage.get(), num_elements);
+        const std::span<real> results(results_storage.get(), num_elements);
+        parallel::first_touch(pool, params, parallel::chunk_size<real>(2));
+        parallel::first_touch(pool, results, parallel::chunk_size<real>(2));
+        const real step = static_cast<real>(M_PI * 8) / num_elements;
+        pool.for_each_chunk(num_elements, parallel::chunk_size<real>(2), [&](std::size_t begin, std::size_t end)
         {
-            const std::string& name = i_names[i];
-            const auto [func1_ms, func2_ms] = performance[i];
-            performance_dat<<name<<"\t"<<static_cast<double>(func1_ms) / num_calls<<"\t"<<static_cast<double>(func2_ms) / num_calls<<std::endl;
-        }
-    }
-    { // performance plot
-        std::ofstream performance_plot("performance.p");
-        performance_plot<<"set style data histogram"<<std::endl;
-        performance_plot<<"set style histogram cluster gap 1"<<std::endl;
-        performance_plot<<"set style fill solid"<<std::endl;
-        performance_plot<<"set boxwidth 0.9"<<std::endl;
-        performance_plot<<"set xtics format \"\""<<std::endl;
-        performance_plot<<"set grid ytics"<<std::endl;
-        performance_plot<<"set title \"performance comparison\""<<std::endl;
-        performance_plot<<"set xlabel \"function\""<<std::endl;
-        performance_plot<<"set ylabel \"avg time (ms)\""<<std::endl;
-        performance_plot<<"plot \"performance.dat\" using 2:xtic(1) title \""<<i_suffixes.first<<"\", \\"<<std::endl;
-        performance_plot<<"\t\"performance.dat\" using 3:xtic(1) title \""<<i_suffixes.second<<"\""<<std::endl;
-        performance_plot<<std::endl;
+            for(std::size_t c = begin; c < end; ++c)
+                params[c] = static_cast<real>(-M_PI * 4) + step * c;
+        });
+
+        math::sin(pool, params, results);
+        const auto start = std::chrono::steady_clock::now();
+        for(std::size_t r = 0; r < num_repetitions; ++r)
+            math::sin(pool, params, results);
+        const auto end = std::chrono::steady_clock::now();
+
+        const double ns = std::chrono::duration<double, std::nano>(end - start).count() / (num_repetitions * num_elements);
+        if(threads == 1)
+            single_thread_ns = ns;
+        report<<threads<<"\t"<<ns<<"\t"<<single_thread_ns / ns<<std::endl;
     }
 }
 
@@ -147,9 +290,9 @@ int main()
     domains.emplace_back(std::make_pair(-1, 1));
     names.emplace_back("asin");
     
-    //unary_functions.emplace_back(std::make_pair([](real x){return std::atan(x);}, [](real x){return interpolation::atan(x);}));
-    //domains.emplace_back(std::make_pair(-5, 5));
-    //names.emplace_back("atan");
+    unary_functions.emplace_back(std::make_pair([](real x){return std::atan(x);}, [](real x){return interpolation::atan(x);}));
+    domains.emplace_back(std::make_pair(-5, 5));
+    names.emplace_back("atan");
     
     unary_functions.emplace_back(std::make_pair([](real x){return std::atan2(x, std::sqrt(1 - x*x));}, [](real x){return interpolation::atan2(x, std::sqrt(1 - x*x));}));
     domains.emplace_back(std::make_pair(-1, 1));
@@ -169,19 +312,11 @@ int main()
             "std",
             "poly");
     }
-    compare_functions_performance(unary_functions, 
-                                 domains,
-                                 names,
-                                 std::make_pair("std", "poly"));
-
-    for(const auto& name : names)
-    {
-        const std::string command = "gnuplot -p \"" + name + "\".p";
-        system(command.c_str());
-    }
 
-    const std::string performance_command = "gnuplot -p \"performance.p\"";
-    system(performance_command.c_str());
+    compare_sincos_performance<real, lookup_table_size>();
+    compare_piecewise_polynomials<real>();
+    compare_evaluation_policies<real>();
+    compare_parallel_scaling<real, lookup_table_size>();
 
     return 0;
 }
\ No newline at end of file
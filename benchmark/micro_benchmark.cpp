@@ -0,0 +1,478 @@
+#include "micro_benchmark.h"
+#include "approximate.h"
+#include "fixed_point.h"
+#include "piecewise_trigonometry.h"
+#include "polynomial_engine.h"
+#include "rotation.h"
+#include "trigonometry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t num_calls = 1 << 16;
+    constexpr std::size_t num_repetitions = 15;
+
+    template<typename real>
+    const char* type_name()
+    {
+        return sizeof(real) == sizeof(float) ? "float" : "double";
+    }
+
+    template<typename real>
+    std::vector<real> create_params(real i_min, real i_max)
+    {
+        // fixed pseudo random order, so neither branch predictor nor prefetcher sees a pattern
+        std::vector<real> params(num_calls);
+        std::uint32_t state = 12345;
+        for(auto& param : params)
+        {
+            state = state * 1664525u + 1013904223u;
+            param = i_min + (i_max - i_min) * static_cast<real>(state >> 8) / static_cast<real>(1u << 24);
+        }
+        return params;
+    }
+
+    /// \brief latency: argument of every call depends on previous result,
+    /// chain adds one multiply and one add to every call
+    template<typename real, typename function_type>
+    micro_benchmark::measurement measure_latency(micro_benchmark::description i_description, const function_type& i_func, const std::vector<real>& i_params)
+    {
+        i_description.mode = "latency";
+        return micro_benchmark::run(i_description, num_calls, num_repetitions, [&]
+        {
+            real chained = 0;
+            for(std::size_t c = 0; c < num_calls; ++c)
+                chained = i_func(i_params[c] + chained) * static_cast<real>(0x1p-60);
+            micro_benchmark::do_not_optimize(chained);
+        });
+    }
+
+    /// \brief throughput: independent calls, results stored
+    template<typename real, typename function_type>
+    micro_benchmark::measurement measure_throughput(micro_benchmark::description i_description, const function_type& i_func,
+        const std::vector<real>& i_params, std::vector<real>& o_results)
+    {
+        i_description.mode = "throughput";
+        return micro_benchmark::run(i_description, num_calls, num_repetitions, [&]
+        {
+            for(std::size_t c = 0; c < num_calls; ++c)
+                o_results[c] = i_func(i_params[c]);
+            micro_benchmark::do_not_optimize(o_results.data());
+        });
+    }
+
+    /// \brief batch: one span call over all parameters
+    template<typename real, typename batch_type>
+    micro_benchmark::measurement measure_batch(micro_benchmark::description i_description, const batch_type& i_batch,
+        const std::vector<real>& i_params, std::vector<real>& o_results)
+    {
+        i_description.mode = "batch";
+        return micro_benchmark::run(i_description, num_calls, num_repetitions, [&]
+        {
+            i_batch(std::span<const real>(i_params), std::span<real>(o_results));
+            micro_benchmark::do_not_optimize(o_results.data());
+        });
+    }
+
+    template<typename real, typename function_type, typename batch_type>
+    void measure_polynomial_function(const std::string& i_name, std::size_t i_size, real i_min, real i_max,
+        const function_type& i_func, const batch_type& i_batch, std::vector<micro_benchmark::measurement>& o_measurements)
+    {
+        const std::vector<real> params = create_params(i_min, i_max);
+        std::vector<real> results(num_calls);
+        const micro_benchmark::description description{i_name, "poly", "", type_name<real>(), i_size};
+
+        o_measurements.push_back(measure_latency(description, i_func, params));
+        o_measurements.push_back(measure_throughput(description, i_func, params, results));
+        o_measurements.push_back(measure_batch(description, i_batch, params, results));
+    }
+
+    template<typename real, typename function_type>
+    void measure_libm_function(const std::string& i_name, real i_min, real i_max,
+        const function_type& i_func, std::vector<micro_benchmark::measurement>& o_measurements)
+    {
+        const std::vector<real> params = create_params(i_min, i_max);
+        std::vector<real> results(num_calls);
+        const micro_benchmark::description description{i_name, "libm", "", type_name<real>(), 0};
+
+        o_measurements.push_back(measure_latency(description, i_func, params));
+        o_measurements.push_back(measure_throughput(description, i_func, params, results));
+    }
+
+    template<typename real, std::size_t size>
+    void measure_polynomial_functions(std::vector<micro_benchmark::measurement>& o_measurements)
+    {
+        using math = trigonometry<real, size>;
+        constexpr real angle = static_cast<real>(M_PI * 4);
+        constexpr real atan2_rcos = static_cast<real>(0.75);
+        static const std::vector<real> rcos(num_calls, atan2_rcos);
+
+        measure_polynomial_function<real>("sin", size, -angle, angle,
+            [](real x){ return math::sin(x); },
+            [](std::span<const real> x, std::span<real> r){ math::sin(x, r); }, o_measurements);
+        measure_polynomial_function<real>("cos", size, -angle, angle,
+            [](real x){ return math::cos(x); },
+            [](std::span<const real> x, std::span<real> r){ math::cos(x, r); }, o_measurements);
+        measure_polynomial_function<real>("tan", size, -angle, angle,
+            [](real x){ return math::tan(x); },
+            [](std::span<const real> x, std::span<real> r){ math::tan(x, r); }, o_measurements);
+        measure_polynomial_function<real>("asin", size, -1, 1,
+            [](real x){ return math::asin(x); },
+            [](std::span<const real> x, std::span<real> r){ math::asin(x, r); }, o_measurements);
+        measure_polynomial_function<real>("atan", size, -5, 5,
+            [](real x){ return math::atan(x); },
+            [](std::span<const real> x, std::span<real> r){ math::atan(x, r); }, o_measurements);
+        measure_polynomial_function<real>("atan2", size, -1, 1,
+            [](real y){ return math::atan2(y, atan2_rcos); },
+            [](std::span<const real> y, std::span<real> r){ math::atan2(y, rcos, r); }, o_measurements);
+    }
+
+    /// \brief scalar sin and atan2 with branching and branchless scalar_evaluation on random
+    /// and sorted arguments; sorted arguments let branch predictor learn quadrant and octant selects
+    template<typename real, std::size_t size>
+    void measure_scalar_policies(std::vector<micro_benchmark::measurement>& o_measurements)
+    {
+        using branching = trigonometry<real, size>;
+        using branchless = trigonometry<real, size, polynomial_evaluation::horner, real, scalar_evaluation::branchless>;
+        constexpr real angle = static_cast<real>(M_PI * 4);
+
+        const auto measure = [&](const char* i_implementation, const std::vector<real>& i_angles, const std::vector<real>& i_ratios,
+            const auto& i_sin, const auto& i_atan2)
+        {
+            std::vector<real> results(num_calls);
+            // rcos = 1/2 - y^2 changes sign inside [-1, 1], so atan2 takes every octant
+            const auto atan2 = [&](real y){ return i_atan2(y, static_cast<real>(0.5) - y * y); };
+            const micro_benchmark::description sin_description{"sin", i_implementation, "", type_name<real>(), size};
+            const micro_benchmark::description atan2_description{"atan2", i_implementation, "", type_name<real>(), size};
+
+            o_measurements.push_back(measure_latency(sin_description, i_sin, i_angles));
+            o_measurements.push_back(measure_throughput(sin_description, i_sin, i_angles, results));
+            o_measurements.push_back(measure_latency(atan2_description, atan2, i_ratios));
+            o_measurements.push_back(measure_throughput(atan2_description, atan2, i_ratios, results));
+        };
+
+        const auto sin_branching = [](real x){ return branching::sin(x); };
+        const auto sin_branchless = [](real x){ return branchless::sin(x); };
+        const auto atan2_branching = [](real y, real x){ return branching::atan2(y, x); };
+        const auto atan2_branchless = [](real y, real x){ return branchless::atan2(y, x); };
+
+        const std::vector<real> random_angles = create_params(-angle, angle);
+        const std::vector<real> random_ratios = create_params<real>(-1, 1);
+        std::vector<real> sorted_angles = random_angles;
+        std::vector<real> sorted_ratios = random_ratios;
+        std::sort(sorted_angles.begin(), sorted_angles.end());
+        std::sort(sorted_ratios.begin(), sorted_ratios.end());
+
+        measure("br:rand", random_angles, random_ratios, sin_branching, atan2_branching);
+        measure("br:sort", sorted_angles, sorted_ratios, sin_branching, atan2_branching);
+        measure("bl:rand", random_angles, random_ratios, sin_branchless, atan2_branchless);
+        measure("bl:sort", sorted_angles, sorted_ratios, sin_branchless, atan2_branchless);
+    }
+
+    /// \brief sin, cos and asin on arguments inside [-pi/4, pi/4] and [-1, 1] without and with
+    /// argument range contract; octant contract drops quadrant reduction, unit contract drops domain check
+    template<typename real, std::size_t size>
+    void measure_argument_ranges(std::vector<micro_benchmark::measurement>& o_measurements)
+    {
+        using math = trigonometry<real, size>;
+        // inside contracts with margin for latency chain
+        constexpr real angle = static_cast<real>(0.75);
+        constexpr real ratio = static_cast<real>(0.99);
+
+        const auto measure = [&](const char* i_name, const char* i_implementation, real i_bound, const auto& i_func, const auto& i_batch)
+        {
+            const std::vector<real> params = create_params(-i_bound, i_bound);
+            std::vector<real> results(num_calls);
+            const micro_benchmark::description description{i_name, i_implementation, "", type_name<real>(), size};
+            o_measurements.push_back(measure_latency(description, i_func, params));
+            o_measurements.push_back(measure_throughput(description, i_func, params, results));
+            o_measurements.push_back(measure_batch(description, i_batch, params, results));
+        };
+
+        measure("sin", "full", angle, [](real x){ return math::sin(x); },
+            [](std::span<const real> x, std::span<real> r){ math::sin(x, r); });
+        measure("sin", "octant", angle, [](real x){ return math::template sin<argument_range::octant>(x); },
+            [](std::span<const real> x, std::span<real> r){ math::template sin<argument_range::octant>(x, r); });
+        measure("cos", "full", angle, [](real x){ return math::cos(x); },
+            [](std::span<const real> x, std::span<real> r){ math::cos(x, r); });
+        measure("cos", "octant", angle, [](real x){ return math::template cos<argument_range::octant>(x); },
+            [](std::span<const real> x, std::span<real> r){ math::template cos<argument_range::octant>(x, r); });
+        measure("asin", "full", ratio, [](real x){ return math::asin(x); },
+            [](std::span<const real> x, std::span<real> r){ math::asin(x, r); });
+        measure("asin", "unit", ratio, [](real x){ return math::template asin<argument_range::unit>(x); },
+            [](std::span<const real> x, std::span<real> r){ math::template asin<argument_range::unit>(x, r); });
+    }
+
+    /// \brief cos, asin and acos of piecewise_trigonometry, same arguments as measure_polynomial_functions
+    template<typename real, std::size_t degree, std::size_t segments>
+    void measure_piecewise_functions(const char* i_implementation, std::vector<micro_benchmark::measurement>& o_measurements)
+    {
+        using math = piecewise_trigonometry<real, degree, segments>;
+        constexpr real angle = static_cast<real>(M_PI * 4);
+
+        const auto measure = [&](const char* i_name, real i_min, real i_max, const auto& i_func, const auto& i_batch)
+        {
+            const std::vector<real> params = create_params(i_min, i_max);
+            std::vector<real> results(num_calls);
+            const micro_benchmark::description description{i_name, i_implementation, "", type_name<real>(), degree + 1};
+            o_measurements.push_back(measure_latency(description, i_func, params));
+            o_measurements.push_back(measure_throughput(description, i_func, params, results));
+            o_measurements.push_back(measure_batch(description, i_batch, params, results));
+        };
+
+        measure("cos", -angle, angle, [](real x){ return math::cos(x); },
+            [](std::span<const real> x, std::span<real> r){ math::cos(x, r); });
+        measure("asin", -1, 1, [](real x){ return math::asin(x); },
+            [](std::span<const real> x, std::span<real> r){ math::asin(x, r); });
+        measure("acos", -1, 1, [](real x){ return math::acos(x); },
+            [](std::span<const real> x, std::span<real> r){ math::acos(x, r); });
+    }
+
+    /// \brief runtime sized polynomials, same functions and arguments as measure_polynomial_functions
+    template<typename real>
+    void measure_engine_functions(std::size_t i_size, std::vector<micro_benchmark::measurement>& o_measurements)
+    {
+        constexpr real angle = static_cast<real>(M_PI * 4);
+        static polynomial_engine<real> engine;
+
+        const auto measure = [&](const std::string& i_name, engine_function i_function, real i_min, real i_max)
+        {
+            const auto approximation = engine.get(i_function, i_size);
+            const std::vector<real> params = create_params(i_min, i_max);
+            std::vector<real> results(num_calls);
+            const micro_benchmark::description description{i_name, "engine", "", type_name<real>(), i_size};
+
+            o_measurements.push_back(measure_latency(description, approximation, params));
+            o_measurements.push_back(measure_throughput(description, approximation, params, results));
+            o_measurements.push_back(measure_batch(description, approximation, params, results));
+        };
+
+        measure("sin", engine_function::sin, -angle, angle);
+        measure("cos", engine_function::cos, -angle, angle);
+        measure("tan", engine_function::tan, -angle, angle);
+        measure("asin", engine_function::asin, -1, 1);
+        measure("atan", engine_function::atan, -5, 5);
+    }
+
+    template<typename real>
+    void measure_libm_functions(std::vector<micro_benchmark::measurement>& o_measurements)
+    {
+        constexpr real angle = static_cast<real>(M_PI * 4);
+        constexpr real atan2_rcos = static_cast<real>(0.75);
+
+        measure_libm_function<real>("sin", -angle, angle, [](real x){ return std::sin(x); }, o_measurements);
+        measure_libm_function<real>("cos", -angle, angle, [](real x){ return std::cos(x); }, o_measurements);
+        measure_libm_function<real>("tan", -angle, angle, [](real x){ return std::tan(x); }, o_measurements);
+        measure_libm_function<real>("asin", -1, 1, [](real x){ return std::asin(x); }, o_measurements);
+        measure_libm_function<real>("atan", -5, 5, [](real x){ return std::atan(x); }, o_measurements);
+        measure_libm_function<real>("atan2", -1, 1, [](real y){ return std::atan2(y, atan2_rcos); }, o_measurements);
+    }
+
+    constexpr long double exp_reference(long double x)
+    {
+        long double term = 1;
+        long double sum = 1;
+        for(int k = 1; k < 30; ++k)
+        {
+            term *= x / k;
+            sum += term;
+        }
+        return sum;
+    }
+
+    template<typename real, std::size_t size>
+    constexpr auto exp_approximation = approximate<real, size>(exp_reference, real(-1), real(1));
+
+    /// \brief exp on [-1, 1] by approximate against libm, shows replacing libm call in hot loop
+    template<typename real, std::size_t size>
+    void measure_approximate_exp(std::vector<micro_benchmark::measurement>& o_measurements)
+    {
+        const std::vector<real> params = create_params<real>(-1, 1);
+        std::vector<real> results(num_calls);
+        const micro_benchmark::description poly_description{"exp", "poly", "", type_name<real>(), size};
+        const micro_benchmark::description libm_description{"exp", "libm", "", type_name<real>(), 0};
+        const auto poly = [](real x){ return exp_approximation<real, size>(x); };
+        const auto libm = [](real x){ return std::exp(x); };
+
+        o_measurements.push_back(measure_latency(libm_description, libm, params));
+        o_measurements.push_back(measure_throughput(libm_description, libm, params, results));
+        o_measurements.push_back(measure_latency(poly_description, poly, params));
+        o_measurements.push_back(measure_throughput(poly_description, poly, params, results));
+        o_measurements.push_back(measure_batch(poly_description,
+            [](std::span<const real> x, std::span<real> r){ evaluate_batch<exp_approximation<real, size>>(x, r); }, params, results));
+    }
+
+    /// \brief exp and its slope as Newton solver needs them: fused evaluate_with_derivative against
+    /// separate evaluation of polynomial and of its derivative
+    template<typename real, std::size_t size>
+    void measure_polynomial_derivative(std::vector<micro_benchmark::measurement>& o_measurements)
+    {
+        static constexpr auto derivative = exp_approximation<real, size>.derivative();
+        const std::vector<real> params = create_params<real>(-1, 1);
+        std::vector<real> results(num_calls);
+        const micro_benchmark::description split_description{"exp+d", "split", "", type_name<real>(), size};
+        const micro_benchmark::description fused_description{"exp+d", "fused", "", type_name<real>(), size};
+        const auto split = [](real x){ return exp_approximation<real, size>(x) + derivative(x); };
+        const auto fused = [](real x)
+        {
+            const auto [value, slope] = exp_approximation<real, size>.evaluate_with_derivative(x);
+            return value + slope;
+        };
+
+        o_measurements.push_back(measure_latency(split_description, split, params));
+        o_measurements.push_back(measure_throughput(split_description, split, params, results));
+        o_measurements.push_back(measure_latency(fused_description, fused, params));
+        o_measurements.push_back(measure_throughput(fused_description, fused, params, results));
+    }
+
+    /// \brief batch sin over arrays larger than caches, float computation on float, float16 and bfloat16
+    /// storage; half storage halves memory traffic of bandwidth bound batches
+    template<std::size_t size>
+    void measure_storage_sin(std::vector<micro_benchmark::measurement>& o_measurements)
+    {
+        constexpr std::size_t storage_calls = 1 << 24;
+        constexpr std::size_t storage_repetitions = 5;
+        constexpr float angle = static_cast<float>(M_PI * 4);
+
+        const auto measure = [&](const char* i_type, auto i_storage)
+        {
+            using storage_type = decltype(i_storage);
+            using math = trigonometry<float, size, polynomial_evaluation::horner, storage_type>;
+            std::vector<storage_type> params(storage_calls);
+            std::vector<storage_type> results(storage_calls);
+            for(std::size_t c = 0; c < storage_calls; ++c)
+                params[c] = simd::convert<storage_type>(-angle + 2 * angle * static_cast<float>(c % 4099) / 4099);
+
+            const micro_benchmark::description description{"sin", "poly", "batch", i_type, size};
+            o_measurements.push_back(micro_benchmark::run(description, storage_calls, storage_repetitions, [&]
+            {
+                math::sin(std::span<const storage_type>(params), std::span<storage_type>(results));
+                micro_benchmark::do_not_optimize(results.data());
+            }));
+        };
+
+        measure("float", float{});
+#if defined(TRIGONOMETRY_FLOAT16)
+        measure("f16", simd::float16{});
+#endif
+        measure("bf16", simd::bfloat16{});
+    }
+
+    /// \brief 2D rotation of arrays larger than caches: fused rotation kernel against batch sincos
+    /// into sin and cos arrays followed by rotation loop, which moves sin and cos through memory twice
+    template<typename real, std::size_t size>
+    void measure_rotation(std::vector<micro_benchmark::measurement>& o_measurements)
+    {
+        using math = trigonometry<real, size>;
+        constexpr std::size_t rotation_calls = 1 << 22;
+        constexpr std::size_t rotation_repetitions = 5;
+        const std::vector<real> angles = create_params(static_cast<real>(-M_PI), static_cast<real>(M_PI));
+        std::vector<real> params(rotation_calls);
+        for(std::size_t c = 0; c < rotation_calls; ++c)
+            params[c] = angles[c % angles.size()];
+        std::vector<real> x(params.rbegin(), params.rend()), y(params);
+        std::vector<real> sin(rotation_calls), cos(rotation_calls), result_x(rotation_calls), result_y(rotation_calls);
+
+        const micro_benchmark::description split_description{"rot2d", "split", "batch", type_name<real>(), size};
+        o_measurements.push_back(micro_benchmark::run(split_description, rotation_calls, rotation_repetitions, [&]
+        {
+            math::sincos(std::span<const real>(params), std::span<real>(sin), std::span<real>(cos));
+            for(std::size_t c = 0; c < rotation_calls; ++c)
+            {
+                result_x[c] = x[c] * cos[c] - y[c] * sin[c];
+                result_y[c] = x[c] * sin[c] + y[c] * cos[c];
+            }
+            micro_benchmark::do_not_optimize(result_x.data());
+            micro_benchmark::do_not_optimize(result_y.data());
+        }));
+
+        const micro_benchmark::description fused_description{"rot2d", "fused", "batch", type_name<real>(), size};
+        o_measurements.push_back(micro_benchmark::run(fused_description, rotation_calls, rotation_repetitions, [&]
+        {
+            rotation<real, size>::rotate(params, x, y, result_x, result_y);
+            micro_benchmark::do_not_optimize(result_x.data());
+            micro_benchmark::do_not_optimize(result_y.data());
+        }));
+    }
+
+    /// \brief batch sin of binary angles in fixed point, Q15 and Q31 integer kernels
+    template<typename value_type, std::size_t size>
+    void measure_fixed_sin(const char* i_type, std::vector<micro_benchmark::measurement>& o_measurements)
+    {
+        using math = fixed_trigonometry<value_type, size>;
+        using angle_type = typename math::angle_type;
+        std::vector<angle_type> params(num_calls);
+        std::vector<value_type> results(num_calls);
+        for(std::size_t c = 0; c < num_calls; ++c)
+            params[c] = static_cast<angle_type>(c * 40503u);
+
+        const micro_benchmark::description description{"sin", "fixed", "batch", i_type, size};
+        o_measurements.push_back(micro_benchmark::run(description, num_calls, num_repetitions, [&]
+        {
+            math::sin(std::span<const angle_type>(params), std::span<value_type>(results));
+            micro_benchmark::do_not_optimize(results.data());
+        }));
+    }
+
+    void print(const std::vector<micro_benchmark::measurement>& i_measurements)
+    {
+        std::cout<<std::left<<std::setw(8)<<"function"<<std::setw(8)<<"impl"<<std::setw(12)<<"mode"<<std::setw(8)<<"type"
+            <<std::setw(6)<<"size"<<std::right<<std::setw(12)<<"ns/call"<<std::setw(10)<<"+-"<<std::setw(12)<<"cycles/call"<<std::endl;
+        for(const auto& m : i_measurements)
+        {
+            std::cout<<std::left<<std::setw(8)<<m.function<<std::setw(8)<<m.implementation<<std::setw(12)<<m.mode<<std::setw(8)<<m.type
+                <<std::setw(6)<<m.polynomial_size<<std::right<<std::fixed<<std::setprecision(3)
+                <<std::setw(12)<<m.ns_mean<<std::setw(10)<<m.ns_stddev<<std::setw(12)<<m.cycles_mean<<std::defaultfloat<<std::endl;
+        }
+    }
+}
+
+/// writes micro_benchmark.json and micro_benchmark.csv into working directory
+int main()
+{
+    std::vector<micro_benchmark::measurement> measurements;
+
+    measure_libm_functions<float>(measurements);
+    measure_polynomial_functions<float, 4>(measurements);
+    measure_polynomial_functions<float, 6>(measurements);
+    measure_polynomial_functions<float, 8>(measurements);
+    measure_scalar_policies<float, 6>(measurements);
+    measure_argument_ranges<float, 6>(measurements);
+    measure_piecewise_functions<float, 3, 64>("pw:64", measurements);
+    measure_engine_functions<float>(6, measurements);
+    measure_approximate_exp<float, 7>(measurements);
+    measure_polynomial_derivative<float, 7>(measurements);
+    measure_storage_sin<6>(measurements);
+    measure_rotation<float, 6>(measurements);
+    measure_fixed_sin<std::int16_t, 3>("q15", measurements);
+    measure_fixed_sin<std::int32_t, 5>("q31", measurements);
+
+    measure_libm_functions<double>(measurements);
+    measure_polynomial_functions<double, 6>(measurements);
+    measure_polynomial_functions<double, 8>(measurements);
+    measure_polynomial_functions<double, 10>(measurements);
+    measure_scalar_policies<double, 8>(measurements);
+    measure_argument_ranges<double, 8>(measurements);
+    measure_piecewise_functions<double, 5, 64>("pw:64", measurements);
+    measure_engine_functions<double>(8, measurements);
+    measure_approximate_exp<double, 13>(measurements);
+    measure_polynomial_derivative<double, 13>(measurements);
+    measure_rotation<double, 8>(measurements);
+
+    print(measurements);
+
+    std::ofstream json("micro_benchmark.json");
+    micro_benchmark::write_json(measurements, json);
+    std::ofstream csv("micro_benchmark.csv");
+    micro_benchmark::write_csv(measurements, csv);
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/// \brief minimal micro benchmark harness
+/// runs a body several times, reports mean, standard deviation and minimum per call
+namespace micro_benchmark
+{
+    /// \brief keeps value alive without forcing it to memory
+    template<typename value_type>
+    inline void do_not_optimize(const value_type& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /// \brief time stamp counter, 0 where not available
+    /// counts reference cycles, which match core cycles only without frequency scaling
+    inline std::uint64_t cycle_count()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    struct measurement
+    {
+        std::string function;
+        std::string implementation;
+        std::string mode;
+        std::string type;
+        std::size_t polynomial_size;
+        std::size_t repetitions;
+        std::size_t calls;
+        double ns_mean;
+        double ns_stddev;
+        double ns_min;
+        double cycles_mean;
+    };
+
+    /// \brief describes what a measurement is for, filled by caller
+    struct description
+    {
+        std::string function;
+        std::string implementation;
+        std::string mode;
+        std::string type;
+        std::size_t polynomial_size;
+    };
+
+    /// \brief calls body() 'repetitions' times, body performs 'calls' calls of measured function
+    template<typename body_type>
+    measurement run(const description& i_description, std::size_t i_calls, std::size_t i_repetitions, body_type&& i_body)
+    {
+        using std::chrono::steady_clock;
+
+        // warm up caches and branch predictors, also faults in output pages
+        i_body();
+
+        std::vector<double> ns(i_repetitions);
+        double cycles_sum = 0;
+        for(std::size_t r = 0; r < i_repetitions; ++r)
+        {
+            const std::uint64_t cycles_start = cycle_count();
+            const auto start = steady_clock::now();
+            i_body();
+            const auto end = steady_clock::now();
+            const std::uint64_t cycles_end = cycle_count();
+
+            ns[r] = std::chrono::duration<double, std::nano>(end - start).count() / i_calls;
+            cycles_sum += static_cast<double>(cycles_end - cycles_start) / i_calls;
+        }
+
+        double sum = 0;
+        double min = ns[0];
+        for(const double value : ns)
+        {
+            sum += value;
+            min = value < min ? value : min;
+        }
+        const double mean = sum / i_repetitions;
+        double square_sum = 0;
+        for(const double value : ns)
+            square_sum += (value - mean) * (value - mean);
+        const double stddev = i_repetitions > 1 ? std::sqrt(square_sum / (i_repetitions - 1)) : 0;
+
+        return measurement{i_description.function, i_description.implementation, i_description.mode, i_description.type,
+            i_description.polynomial_size, i_repetitions, i_calls, mean, stddev, min, cycles_sum / i_repetitions};
+    }
+
+    inline void write_csv(const std::vector<measurement>& i_measurements, std::ostream& o_stream)
+    {
+        o_stream<<"function,implementation,mode,type,polynomial_size,repetitions,calls,ns_mean,ns_stddev,ns_min,cycles_mean"<<std::endl;
+        for(const auto& m : i_measurements)
+        {
+            o_stream<<m.function<<","<<m.implementation<<","<<m.mode<<","<<m.type<<","<<m.polynomial_size<<","
+                <<m.repetitions<<","<<m.calls<<","<<m.ns_mean<<","<<m.ns_stddev<<","<<m.ns_min<<","<<m.cycles_mean<<std::endl;
+        }
+    }
+
+    inline void write_json(const std::vector<measurement>& i_measurements, std::ostream& o_stream)
+    {
+        o_stream<<"{"<<std::endl<<"  \"benchmarks\": ["<<std::endl;
+        for(std::size_t i = 0; i < i_measurements.size(); ++i)
+        {
+            const auto& m = i_measurements[i];
+            o_stream<<"    {\"function\": \""<<m.function<<"\", \"implementation\": \""<<m.implementation
+                <<"\", \"mode\": \""<<m.mode<<"\", \"type\": \""<<m.type<<"\", \"polynomial_size\": "<<m.polynomial_size
+                <<", \"repetitions\": "<<m.repetitions<<", \"calls\": "<<m.calls
+                <<", \"ns_mean\": "<<m.ns_mean<<", \"ns_stddev\": "<<m.ns_stddev<<", \"ns_min\": "<<m.ns_min
+                <<", \"cycles_mean\": "<<m.cycles_mean<<"}"<<(i + 1 < i_measurements.size() ? "," : "")<<std::endl;
+        }
+        o_stream<<"  ]"<<std::endl<<"}"<<std::endl;
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "piecewise_polynomial.h"
+#include "polynomial.h"
+#include "simd.h"
+
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+namespace _approximate_detail
+{
+    using fit_type = polynomial_fit_detail::fit_type;
+
+    /// \brief function evaluated in fit_type, whatever type it takes and returns
+    template<typename function_type>
+    struct fit_function
+    {
+        const function_type& function;
+
+        constexpr fit_type operator()(fit_type x) const
+        {
+            return static_cast<fit_type>(function(x));
+        }
+    };
+
+    /// \brief scalar type polynomial or piecewise polynomial evaluates in
+    template<const auto& approximation>
+    using result_type = std::remove_cvref_t<decltype(approximation(0.f))>;
+
+    /// \brief kernel for simd::transform evaluating object with static storage duration
+    template<const auto& approximation>
+    struct approximation_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static value_type apply(const value_type& x)
+        {
+            return approximation(x);
+        }
+    };
+}
+
+/// \brief Polynomial with 'size' coefficients approximating function over [min, max]
+/// fitting is done in long double and coefficients are rounded to 'type' afterwards.
+/// 'node_policy' is polynomial_nodes::minimax (Remez exchange, smallest max error),
+/// polynomial_nodes::chebyshev or polynomial_nodes::equispaced (interpolation).
+/// Function may be constexpr (table is built at compile time) or any runtime callable,
+/// e.g. std::exp, sigmoid or measured transfer curve.
+/// \param function: callable, result convertible to long double, taking long double
+template<typename type, std::size_t size, typename evaluation_policy = polynomial_evaluation::horner,
+    typename node_policy = polynomial_nodes::minimax, typename function_type>
+constexpr polynomial<type, size, evaluation_policy> approximate(const function_type& function, type min, type max, node_policy = {})
+{
+    using fit_type = _approximate_detail::fit_type;
+    const _approximate_detail::fit_function<function_type> fit_function{function};
+
+    const auto fitted = [&]
+    {
+        if constexpr (std::is_same_v<node_policy, polynomial_nodes::minimax>)
+            return polynomial<fit_type, size>::fit_minimax(fit_function, min, max);
+        else
+            return polynomial<fit_type, size>::template interpolate<node_policy>(fit_function, min, max);
+    }();
+
+    typename polynomial<type, size, evaluation_policy>::coefficient_list_type coefficients{};
+    for (std::size_t i = 0; i < size; ++i)
+        coefficients[i] = static_cast<type>(fitted.getCoefficients()[i]);
+    return polynomial<type, size, evaluation_policy>(coefficients);
+}
+
+/// \brief approximate for function given by type, function object is value-initialized
+/// e.g. stateless lambda type: approximate<decltype(sigmoid), float, 8>(-4.f, 4.f)
+template<typename function_type, typename type, std::size_t size, typename evaluation_policy = polynomial_evaluation::horner,
+    typename node_policy = polynomial_nodes::minimax>
+    requires (!std::is_arithmetic_v<function_type>)
+constexpr polynomial<type, size, evaluation_policy> approximate(type min, type max, node_policy nodes = {})
+{
+    return approximate<type, size, evaluation_policy>(function_type{}, min, max, nodes);
+}
+
+/// \brief Piecewise polynomial approximating function over [min, max] in 'segments' segments
+/// 'node_policy' as for approximate, applied on every segment
+/// \param function: callable, result convertible to long double, taking long double
+template<typename type, std::size_t degree, std::size_t segments, typename node_policy = polynomial_nodes::minimax, typename function_type>
+constexpr piecewise_polynomial<type, degree, segments> approximate_piecewise(const function_type& function, type min, type max, node_policy = {})
+{
+    using table_type = piecewise_polynomial<type, degree, segments>;
+    const _approximate_detail::fit_function<function_type> fit_function{function};
+
+    if constexpr (std::is_same_v<node_policy, polynomial_nodes::minimax>)
+        return table_type::fit_minimax(fit_function, min, max);
+    else
+        return table_type::template interpolate<node_policy>(fit_function, min, max);
+}
+
+template<typename function_type, typename type, std::size_t degree, std::size_t segments, typename node_policy = polynomial_nodes::minimax>
+    requires (!std::is_arithmetic_v<function_type>)
+constexpr piecewise_polynomial<type, degree, segments> approximate_piecewise(type min, type max, node_policy nodes = {})
+{
+    return approximate_piecewise<type, degree, segments>(function_type{}, min, max, nodes);
+}
+
+/// \brief batch evaluation of polynomial or piecewise polynomial with static storage duration
+/// result[i] = approximation(x[i]) by simd kernels of widest instruction set running CPU supports,
+/// same dispatch as trigonometry batch functions. result may alias x.
+///     static constexpr auto exp_table = approximate<float, 8>(exp_reference, -1.f, 1.f);
+///     evaluate_batch<exp_table>(x, result);
+template<const auto& approximation>
+void evaluate_batch(std::span<const _approximate_detail::result_type<approximation>> x, std::span<_approximate_detail::result_type<approximation>> result)
+{
+    assert(result.size() >= x.size());
+    simd::transform<_approximate_detail::approximation_kernel<approximation>>(x.size(), result.data(), x.data());
+}
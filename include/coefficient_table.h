@@ -0,0 +1,222 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <span>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TRIGONOMETRY_MAPPED_FILE
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/// \brief Precomputed kernel coefficients
+/// table_generator fits every kernel polynomial once and writes them twice:
+/// - trigonometry_tables.h, explicit specializations of 'generated'; with TRIGONOMETRY_GENERATED_TABLES
+///   defined (and the generated directory on include path) trigonometry takes coefficients from it
+///   instead of fitting them in every translation unit;
+/// - trigonometry_tables.bin, binary table read through 'view', e.g. from 'mapped_file',
+///   which polynomial_engine::load adopts without fitting or copying.
+namespace coefficient_table
+{
+    /// \brief kernel polynomials of trigonometry and polynomial_engine
+    enum class kernel : std::uint32_t
+    {
+        sin_octant,
+        cos_octant,
+        asin,
+        atan_octant,
+        count
+    };
+
+    constexpr std::size_t kernel_count = static_cast<std::size_t>(kernel::count);
+
+    /// \brief coefficients of 'kernel' with 'size' coefficients in 'type', specialized by generated header:
+    /// available = true, coefficients (std::array<type, size>) and max_error (absolute, on kernel domain)
+    template<kernel id, typename type, std::size_t size>
+    struct generated
+    {
+        constexpr static bool available = false;
+    };
+
+    /// binary layout, native byte order: file_header, record_header[record_count], coefficient blocks;
+    /// blocks start at multiples of block_alignment, so a mapped file is read in place
+    constexpr std::uint64_t file_magic = 0x3142415447495254ull; // "TRIGTAB1"
+    constexpr std::uint32_t file_version = 1;
+    constexpr std::size_t block_alignment = 64;
+
+    struct file_header
+    {
+        std::uint64_t magic;
+        std::uint32_t version;
+        std::uint32_t record_count;
+    };
+
+    struct record_header
+    {
+        std::uint32_t kernel_id;
+        std::uint32_t scalar_size;
+        std::uint32_t size;
+        std::uint32_t reserved;
+        std::uint64_t offset;
+        double max_error;
+    };
+
+    /// \brief read only view of a binary table, bytes must outlive view and everything taken from it
+    class view {
+    public:
+        view() = default;
+
+        /// \brief checks header and record bounds, invalid tables give an empty view
+        explicit view(std::span<const std::byte> bytes)
+        {
+            file_header header{};
+            if (bytes.size() < sizeof(header))
+                return;
+            std::memcpy(&header, bytes.data(), sizeof(header));
+            if (header.magic != file_magic || header.version != file_version ||
+                bytes.size() < sizeof(header) + std::size_t(header.record_count) * sizeof(record_header))
+                return;
+
+            std::vector<record_header> records(header.record_count);
+            std::memcpy(records.data(), bytes.data() + sizeof(header), records.size() * sizeof(record_header));
+            for (const record_header& record : records)
+                if (record.offset % block_alignment != 0 || record.offset > bytes.size() ||
+                    std::size_t(record.scalar_size) * record.size > bytes.size() - record.offset)
+                    return;
+
+            mBytes = bytes;
+            mRecords = std::move(records);
+        }
+
+        bool valid() const { return !mBytes.empty(); }
+
+        std::span<const record_header> records() const { return mRecords; }
+
+        /// \brief record of kernel with 'size' coefficients of 'scalar_size' bytes, nullptr if absent
+        const record_header* find(kernel id, std::size_t scalar_size, std::size_t size) const
+        {
+            for (const record_header& record : mRecords)
+                if (record.kernel_id == static_cast<std::uint32_t>(id) && record.scalar_size == scalar_size && record.size == size)
+                    return &record;
+            return nullptr;
+        }
+
+        /// \brief coefficients of record in place, record must be of 'type'
+        template<typename type>
+        std::span<const type> coefficients(const record_header& record) const
+        {
+            return { reinterpret_cast<const type*>(mBytes.data() + record.offset), record.size };
+        }
+
+        /// \brief coefficients of kernel in 'type', empty if absent
+        template<typename type>
+        std::span<const type> coefficients(kernel id, std::size_t size) const
+        {
+            const record_header* record = find(id, sizeof(type), size);
+            return record != nullptr ? coefficients<type>(*record) : std::span<const type>();
+        }
+
+    private:
+        std::span<const std::byte> mBytes;
+        std::vector<record_header> mRecords;
+    };
+
+    /// \brief collects coefficient records and writes binary table
+    class builder {
+    public:
+        template<typename type>
+        void add(kernel id, std::span<const type> coefficients, double max_error)
+        {
+            entry new_entry{{static_cast<std::uint32_t>(id), sizeof(type), static_cast<std::uint32_t>(coefficients.size()), 0, 0, max_error}, {}};
+            new_entry.bytes.resize(coefficients.size_bytes());
+            std::memcpy(new_entry.bytes.data(), coefficients.data(), coefficients.size_bytes());
+            mEntries.push_back(std::move(new_entry));
+        }
+
+        void write(std::ostream& stream) const
+        {
+            const auto align = [](std::uint64_t offset) { return (offset + block_alignment - 1) / block_alignment * block_alignment; };
+
+            const file_header header{file_magic, file_version, static_cast<std::uint32_t>(mEntries.size())};
+            std::vector<record_header> records;
+            std::uint64_t offset = align(sizeof(header) + mEntries.size() * sizeof(record_header));
+            for (const entry& e : mEntries)
+            {
+                records.push_back(e.record);
+                records.back().offset = offset;
+                offset = align(offset + e.bytes.size());
+            }
+
+            std::vector<std::byte> file(offset);
+            std::memcpy(file.data(), &header, sizeof(header));
+            std::memcpy(file.data() + sizeof(header), records.data(), records.size() * sizeof(record_header));
+            for (std::size_t i = 0; i < mEntries.size(); ++i)
+                std::memcpy(file.data() + records[i].offset, mEntries[i].bytes.data(), mEntries[i].bytes.size());
+            stream.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+        }
+
+    private:
+        struct entry
+        {
+            record_header record;
+            std::vector<std::byte> bytes;
+        };
+
+        std::vector<entry> mEntries;
+    };
+
+#if defined(TRIGONOMETRY_MAPPED_FILE)
+    /// \brief read only memory mapping of a whole file, empty if file cannot be mapped
+    class mapped_file {
+    public:
+        explicit mapped_file(const char* path)
+        {
+            const int descriptor = ::open(path, O_RDONLY);
+            if (descriptor < 0)
+                return;
+            struct stat status{};
+            if (::fstat(descriptor, &status) == 0 && status.st_size > 0)
+            {
+                void* address = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+                if (address != MAP_FAILED)
+                {
+                    mAddress = address;
+                    mSize = static_cast<std::size_t>(status.st_size);
+                }
+            }
+            ::close(descriptor);
+        }
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        ~mapped_file()
+        {
+            if (mAddress != nullptr)
+                ::munmap(mAddress, mSize);
+        }
+
+        bool is_open() const { return mAddress != nullptr; }
+
+        std::span<const std::byte> bytes() const
+        {
+            return { static_cast<const std::byte*>(mAddress), mSize };
+        }
+
+    private:
+        void* mAddress = nullptr;
+        std::size_t mSize = 0;
+    };
+#endif
+}
+
+#if defined(TRIGONOMETRY_GENERATED_TABLES)
+#include "trigonometry_tables.h"
+#endif
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <type_traits>
+
+/// \brief unevaluated sum of two doubles, about 106 bits of mantissa
+/// constexpr arithmetic by error free transformations (Dekker, Knuth), exponent range of double.
+/// Used as fitting precision where long double is not enough, e.g. high degree double tables:
+///     polynomial<double, 14>::fit_minimax<double_double>(reference, min, max)
+/// Conversions to and from other floating point types are explicit, except from arithmetic values,
+/// so literals and integers mix with double_double freely.
+struct double_double
+{
+    double high;
+    double low;
+
+    constexpr double_double() :
+        high(0),
+        low(0)
+    {
+    }
+
+    template<typename value_type>
+        requires std::is_arithmetic_v<value_type>
+    constexpr double_double(value_type value) :
+        high(static_cast<double>(value)),
+        low(0)
+    {
+        // long double carries bits below double mantissa
+        if constexpr (std::is_same_v<value_type, long double>)
+            low = static_cast<double>(value - static_cast<long double>(high));
+    }
+
+    constexpr double_double(double high_part, double low_part) :
+        high(high_part),
+        low(low_part)
+    {
+    }
+
+    template<typename value_type>
+        requires std::is_floating_point_v<value_type>
+    constexpr explicit operator value_type() const
+    {
+        if constexpr (sizeof(value_type) > sizeof(double))
+            return static_cast<value_type>(high) + static_cast<value_type>(low);
+        else
+            return static_cast<value_type>(high + low);
+    }
+
+    /// \brief s + e = a + b exactly
+    constexpr static double_double two_sum(double a, double b)
+    {
+        const double sum = a + b;
+        const double b_virtual = sum - a;
+        return { sum, (a - (sum - b_virtual)) + (b - b_virtual) };
+    }
+
+    /// \brief two_sum for |a| >= |b|
+    constexpr static double_double quick_two_sum(double a, double b)
+    {
+        const double sum = a + b;
+        return { sum, b - (sum - a) };
+    }
+
+    /// \brief p + e = a * b exactly, Dekker split into 26 bit halves
+    constexpr static double_double two_product(double a, double b)
+    {
+        constexpr double splitter = 134217729.0; // 2^27 + 1
+        const double a_scaled = splitter * a;
+        const double a_high = a_scaled - (a_scaled - a);
+        const double a_low = a - a_high;
+        const double b_scaled = splitter * b;
+        const double b_high = b_scaled - (b_scaled - b);
+        const double b_low = b - b_high;
+
+        const double product = a * b;
+        return { product, ((a_high * b_high - product) + a_high * b_low + a_low * b_high) + a_low * b_low };
+    }
+
+    friend constexpr double_double operator-(const double_double& a)
+    {
+        return { -a.high, -a.low };
+    }
+
+    friend constexpr double_double operator+(const double_double& a, const double_double& b)
+    {
+        const double_double high = two_sum(a.high, b.high);
+        const double_double low = two_sum(a.low, b.low);
+        const double_double partial = quick_two_sum(high.high, high.low + low.high);
+        return quick_two_sum(partial.high, partial.low + low.low);
+    }
+
+    friend constexpr double_double operator-(const double_double& a, const double_double& b)
+    {
+        return a + -b;
+    }
+
+    friend constexpr double_double operator*(const double_double& a, const double_double& b)
+    {
+        const double_double product = two_product(a.high, b.high);
+        return quick_two_sum(product.high, product.low + (a.high * b.low + a.low * b.high));
+    }
+
+    /// long division, three quotient digits
+    friend constexpr double_double operator/(const double_double& a, const double_double& b)
+    {
+        const double first = a.high / b.high;
+        const double_double remainder = a - b * first;
+        const double second = remainder.high / b.high;
+        const double third = (remainder - b * second).high / b.high;
+        return quick_two_sum(first, second) + third;
+    }
+
+    constexpr double_double& operator+=(const double_double& other) { return *this = *this + other; }
+    constexpr double_double& operator-=(const double_double& other) { return *this = *this - other; }
+    constexpr double_double& operator*=(const double_double& other) { return *this = *this * other; }
+    constexpr double_double& operator/=(const double_double& other) { return *this = *this / other; }
+
+    friend constexpr bool operator==(const double_double& a, const double_double& b)
+    {
+        return a.high == b.high && a.low == b.low;
+    }
+
+    friend constexpr bool operator<(const double_double& a, const double_double& b)
+    {
+        return a.high < b.high || (a.high == b.high && a.low < b.low);
+    }
+
+    friend constexpr bool operator>(const double_double& a, const double_double& b) { return b < a; }
+    friend constexpr bool operator<=(const double_double& a, const double_double& b) { return !(b < a); }
+    friend constexpr bool operator>=(const double_double& a, const double_double& b) { return !(a < b); }
+};
@@ -0,0 +1,274 @@
+#pragma once
+
+#include "polynomial.h"
+#include "simd.h"
+#include "trigonometry.h"
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+/// \brief Fixed point formats and binary angles
+/// Qn value: signed integer v stands for v / 2^n, Q15 in int16_t, Q31 in int32_t.
+/// Binary angle: unsigned integer a stands for 2*pi * a / 2^bits, so the full range is one turn
+/// and phase accumulators wrap exactly like the angle does.
+namespace fixed_point
+{
+    /// \brief fraction bits of full scale Qn format of value_type: 15 for int16_t, 31 for int32_t
+    template<typename value_type>
+    inline constexpr int fraction_bits = std::numeric_limits<value_type>::digits;
+
+    /// \brief unsigned binary angle type matching value_type, uint16_t for Q15, uint32_t for Q31
+    template<typename value_type>
+    using angle_type = std::make_unsigned_t<value_type>;
+
+    /// \brief Q'fraction' value nearest to x, x must be representable
+    template<typename value_type, int fraction = fraction_bits<value_type>>
+    constexpr value_type from_real(long double x)
+    {
+        const long double scaled = x * static_cast<long double>(1ull << fraction);
+        const long double rounded = scaled < 0 ? scaled - 0.5l : scaled + 0.5l;
+        assert(rounded > static_cast<long double>(std::numeric_limits<value_type>::min()) - 1 &&
+            rounded < static_cast<long double>(std::numeric_limits<value_type>::max()) + 1);
+        return static_cast<value_type>(static_cast<std::int64_t>(rounded));
+    }
+
+    template<typename real_type, int fraction, typename value_type>
+    constexpr real_type to_real(value_type x)
+    {
+        return static_cast<real_type>(x) / static_cast<real_type>(1ull << fraction);
+    }
+
+    /// \brief binary angle nearest to 'radians', wrapped into one turn
+    template<typename angle_type>
+    constexpr angle_type binary_angle(long double radians)
+    {
+        constexpr long double turn = static_cast<long double>(std::numeric_limits<angle_type>::max()) + 1;
+        const long double turns = radians / (2 * static_cast<long double>(M_PI));
+        const long double fraction = turns - static_cast<long double>(static_cast<std::int64_t>(turns));
+        const long double scaled = (fraction < 0 ? fraction + 1 : fraction) * turn + 0.5l;
+        return static_cast<angle_type>(static_cast<std::uint64_t>(scaled));
+    }
+
+    template<typename real_type, typename angle_type>
+    constexpr real_type to_radians(angle_type angle)
+    {
+        constexpr long double turn = static_cast<long double>(std::numeric_limits<angle_type>::max()) + 1;
+        return static_cast<real_type>(2 * static_cast<long double>(M_PI) * angle / turn);
+    }
+}
+
+namespace _fixed_detail
+{
+    /// products of two values are formed in wide_type, int32_t for int16_t and int64_t for int32_t
+    template<typename value_type>
+    using wide_type = std::conditional_t<sizeof(value_type) == 2, std::int32_t, std::int64_t>;
+
+    /// \brief (a * b) >> shift, rounded to nearest; a, b are scalars or packs of Qn values,
+    /// product_type holds the product of two of them
+    /// Narrowing keeps only the low lane bits of the shifted product, so the shift may be logical,
+    /// which packs of 64 bit lanes have without AVX-512.
+    template<int shift, typename product_type, typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr value_type multiply_shift(const value_type& a, const value_type& b)
+    {
+        using scalar_type = simd::element_type<value_type>;
+        using unsigned_product = std::make_unsigned_t<product_type>;
+        const auto product = simd::lane_cast<product_type>(a) * simd::lane_cast<product_type>(b) + (product_type(1) << (shift - 1));
+        if constexpr (sizeof(product_type) > sizeof(scalar_type))
+            return simd::lane_cast<scalar_type>(simd::reinterpret_lanes<unsigned_product>(product) >> shift);
+        else
+            return static_cast<value_type>(product >> shift);
+    }
+}
+
+/// \brief Polynomial with coefficients in Q'fraction' fixed point
+/// Evaluated by Horner's scheme in integer arithmetic, products are rounded back to Q'fraction',
+/// so argument and result are Q'fraction' as well. Coefficients come from any polynomial,
+/// typically fitted at compile time in long double, and must be within value_type range.
+template<typename value_type, std::size_t size, int fraction = fixed_point::fraction_bits<value_type>>
+class fixed_polynomial {
+public:
+    static_assert(std::is_integral_v<value_type> && std::is_signed_v<value_type>);
+
+    using coefficient_list_type = std::array<value_type, size>;
+
+    constexpr fixed_polynomial() = default;
+
+    constexpr explicit fixed_polynomial(const coefficient_list_type& coefficients) :
+        mCoefficients(coefficients)
+    {
+    }
+
+    /// \brief coefficients of p scaled to Q'fraction' and rounded
+    template<typename type, typename evaluation_policy>
+    constexpr static fixed_polynomial from(const polynomial<type, size, evaluation_policy>& p)
+    {
+        coefficient_list_type coefficients{};
+        for (std::size_t i = 0; i < size; ++i)
+            coefficients[i] = fixed_point::from_real<value_type, fraction>(static_cast<long double>(p.getCoefficients()[i]));
+        return fixed_polynomial(coefficients);
+    }
+
+    /// \brief value in x, x is scalar or simd pack of value_type or of wider lanes holding Q'fraction' values
+    template<typename argument_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr argument_type operator()(const argument_type& x) const
+    {
+        argument_type result = simd::broadcast<argument_type>(mCoefficients[size-1]);
+        for (std::size_t i = size-1; i-- > 0;)
+            result = _fixed_detail::multiply_shift<fraction, _fixed_detail::wide_type<value_type>>(result, x) + mCoefficients[i];
+        return result;
+    }
+
+    constexpr const coefficient_list_type& getCoefficients() const
+    {
+        return mCoefficients;
+    }
+
+private:
+    coefficient_list_type mCoefficients{};
+};
+
+namespace _fixed_detail
+{
+    /// kernel polynomials in z = u^2, u in [-1, 1] covering [-pi/4, pi/4]:
+    /// sin(pi/4 * u) = u * S(z), cos(pi/4 * u) = 1 - D(z); S and D stay below 1, so coefficients are full scale Qn
+    template<typename value_type, std::size_t n>
+    constexpr auto sin_polynomial = fixed_polynomial<value_type, n>::from(
+        polynomial<long double, n>::fit_minimax([](long double z)
+        {
+            return static_cast<long double>(M_PI_4) * _math_detail::sin_sqrt_reference(z * _math_detail::octant_kernel_end);
+        }, 0, 1));
+
+    template<typename value_type, std::size_t n>
+    constexpr auto versine_polynomial = fixed_polynomial<value_type, n>::from(
+        polynomial<long double, n>::fit_minimax([](long double z)
+        {
+            return 1 - _math_detail::cos_sqrt_reference(z * _math_detail::octant_kernel_end);
+        }, 0, 1));
+
+    /// \brief sin and cos in full scale Qn of binary angle, scalar or pack of uint32_t lanes
+    /// Lanes are 32 bit for Q15 as well: angle and result occupy the low 16 bits, Q15 products
+    /// then fit the lane and need no widening, and packs keep native width.
+    /// Reduction is integer masking: quadrant is the top two bits of angle + 1/8 turn,
+    /// the rest is r in [-1/8, 1/8) turn. Results of 1.0 saturate to largest Qn value.
+    template<typename value_type, std::size_t n>
+    struct sincos_kernel
+    {
+        template<typename angle_value>
+        TRIGONOMETRY_FORCE_INLINE constexpr static void apply(const angle_value& angle, angle_value& sin, angle_value& cos)
+        {
+            using lane_value = decltype(simd::reinterpret_lanes<std::int32_t>(angle));
+            using product_type = _fixed_detail::wide_type<value_type>;
+            constexpr int fraction = fixed_point::fraction_bits<value_type>;
+            constexpr int angle_shift = 31 - fraction;
+            constexpr std::int32_t largest = std::numeric_limits<value_type>::max();
+
+            // angle in top bits, one turn is 2^32
+            const angle_value turn_angle = static_cast<angle_value>(angle << angle_shift);
+            const angle_value quadrant = static_cast<angle_value>((turn_angle + (1u << 29)) >> 30);
+            const angle_value reduced = static_cast<angle_value>(turn_angle - static_cast<angle_value>(quadrant << 30));
+            // u = r / (1/8 turn) and z = u^2 in Qn, u = -1 squares to 1.0 which saturates
+            const lane_value u = static_cast<lane_value>(simd::reinterpret_lanes<std::int32_t>(static_cast<angle_value>(reduced << 2)) >> angle_shift);
+            const lane_value square = _fixed_detail::multiply_shift<fraction, product_type>(u, u);
+            const lane_value z = simd::select(u == -largest - 1, simd::broadcast<lane_value>(largest), square);
+
+            constexpr auto& sin_kernel = sin_polynomial<value_type, n>;
+            constexpr auto& versine_kernel = versine_polynomial<value_type, n>;
+            const lane_value octant_sin = _fixed_detail::multiply_shift<fraction, product_type>(u, sin_kernel(z));
+            // 1 - D is (largest - D) + 1, except D = 0 where 1.0 saturates to largest
+            const lane_value versine = static_cast<lane_value>(versine_kernel(z) - 1);
+            const lane_value octant_cos = static_cast<lane_value>(largest - simd::select(versine < 0, simd::broadcast<lane_value>(0), versine));
+
+            const lane_value signed_quadrant = simd::reinterpret_lanes<std::int32_t>(quadrant);
+            const auto odd = (signed_quadrant & 1) != 0;
+            const auto sin_negative = (signed_quadrant & 2) != 0;
+            const auto cos_negative = ((signed_quadrant + 1) & 2) != 0;
+            const lane_value sin_magnitude = simd::select(odd, octant_cos, octant_sin);
+            const lane_value cos_magnitude = simd::select(odd, octant_sin, octant_cos);
+            sin = simd::reinterpret_lanes<std::uint32_t>(simd::select(sin_negative, static_cast<lane_value>(-sin_magnitude), sin_magnitude));
+            cos = simd::reinterpret_lanes<std::uint32_t>(simd::select(cos_negative, static_cast<lane_value>(-cos_magnitude), cos_magnitude));
+        }
+    };
+
+    template<typename value_type, std::size_t n>
+    struct sin_kernel
+    {
+        template<typename angle_value>
+        TRIGONOMETRY_FORCE_INLINE constexpr static angle_value apply(const angle_value& angle)
+        {
+            angle_value sin{};
+            angle_value cos{};
+            sincos_kernel<value_type, n>::apply(angle, sin, cos);
+            return sin;
+        }
+    };
+
+    template<typename value_type, std::size_t n>
+    struct cos_kernel
+    {
+        template<typename angle_value>
+        TRIGONOMETRY_FORCE_INLINE constexpr static angle_value apply(const angle_value& angle)
+        {
+            angle_value sin{};
+            angle_value cos{};
+            sincos_kernel<value_type, n>::apply(angle, sin, cos);
+            return cos;
+        }
+    };
+}
+
+/// \brief sin and cos of binary angles in full scale fixed point
+/// value_type int16_t gives Q15 results of uint16_t angles, int32_t gives Q31 results of uint32_t angles
+/// (full unsigned range is 2*pi). No floating point is involved: coefficients are fitted at compile
+/// time and scaled to Qn, evaluation uses integer multiplies and shifts only.
+/// Max error is about 2 lsb with polynomial_size 3 for Q15 and 5 for Q31.
+template<typename value_type, std::size_t polynomial_size>
+struct fixed_trigonometry
+{
+    using angle_type = fixed_point::angle_type<value_type>;
+
+    constexpr static value_type sin(angle_type angle)
+    {
+        return static_cast<value_type>(_fixed_detail::sin_kernel<value_type, polynomial_size>::apply(std::uint32_t{angle}));
+    }
+
+    constexpr static value_type cos(angle_type angle)
+    {
+        return static_cast<value_type>(_fixed_detail::cos_kernel<value_type, polynomial_size>::apply(std::uint32_t{angle}));
+    }
+
+    constexpr static void sincos(angle_type angle, value_type* sin, value_type* cos)
+    {
+        std::uint32_t sin_bits{};
+        std::uint32_t cos_bits{};
+        _fixed_detail::sincos_kernel<value_type, polynomial_size>::apply(std::uint32_t{angle}, sin_bits, cos_bits);
+        *sin = static_cast<value_type>(sin_bits);
+        *cos = static_cast<value_type>(cos_bits);
+    }
+
+    /// \brief batch versions, result[i] = f(angle[i]); evaluated by integer simd kernels in 32 bit lanes
+    /// of widest instruction set running CPU supports
+    static void sin(std::span<const angle_type> angle, std::span<value_type> result)
+    {
+        assert(result.size() >= angle.size());
+        simd::transform<_fixed_detail::sin_kernel<value_type, polynomial_size>, std::uint32_t>(angle.size(), result.data(), angle.data());
+    }
+
+    static void cos(std::span<const angle_type> angle, std::span<value_type> result)
+    {
+        assert(result.size() >= angle.size());
+        simd::transform<_fixed_detail::cos_kernel<value_type, polynomial_size>, std::uint32_t>(angle.size(), result.data(), angle.data());
+    }
+
+    /// sin and cos must not alias each other
+    static void sincos(std::span<const angle_type> angle, std::span<value_type> sin, std::span<value_type> cos)
+    {
+        assert(sin.size() >= angle.size() && cos.size() >= angle.size());
+        simd::transform_pair<_fixed_detail::sincos_kernel<value_type, polynomial_size>, std::uint32_t>(angle.size(), sin.data(), cos.data(), angle.data());
+    }
+};
@@ -1,97 +1,240 @@
 #pragma once
 
+#include <bit>
+#include <cassert>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <limits>
+#include <type_traits>
 
 namespace _math_helper
 {
-    // compile-time pow
-    template <typename computation_type, std::size_t power>
-    constexpr computation_type pow(computation_type base)
-    {
-        return base * pow<computation_type, power-1>(base);
-    }
+    // square root by Newton-Raphson iteration of 1/sqrt(x) with bounded iteration count
+    template<typename computation_type>
+    struct rsqrt_traits;
+
     template<>
-    constexpr double pow<double, 0>(double base)
+    struct rsqrt_traits<float>
     {
-        return 1.0;
-    }
+        using integer_type = std::uint32_t;
+        // halves exponent and mantissa bits at once, relative error of guess is below 3.5%
+        static constexpr integer_type magic = 0x5f375a86u;
+        // error is squared by each step: 3.5e-2, 1.8e-3, 4.7e-6, 3.3e-11
+        static constexpr std::size_t iterations = 3;
+    };
+
     template<>
-    constexpr float pow<float, 0>(float base)
+    struct rsqrt_traits<double>
     {
-        return 1.0f;
-    }
-    template<>
-    constexpr size_t pow<size_t, 0>(size_t base)
+        using integer_type = std::uint64_t;
+        static constexpr integer_type magic = 0x5fe6eb50c7b537a9ull;
+        static constexpr std::size_t iterations = 4;
+    };
+
+    template<typename computation_type>
+    constexpr computation_type rsqrt_newton(computation_type x, computation_type y, std::size_t iterations)
     {
-        return 1;
+        const computation_type half_x = x * static_cast<computation_type>(0.5);
+        for (std::size_t i = 0; i < iterations; ++i)
+            y = y * (static_cast<computation_type>(1.5) - half_x * y * y);
+        return y;
     }
 
-    template <typename computation_type>
-    computation_type sqrtNewtonRaphson(computation_type x, computation_type curr, computation_type prev)
-	{
-		return curr == prev
-			? curr
-			: sqrtNewtonRaphson(x, static_cast<computation_type>(0.5) * (curr + x / curr), curr);
-	}
+    //compile-time reciprocal square root, x must be positive and finite
+    template<typename computation_type>
+    constexpr computation_type rsqrt_positive(computation_type x)
+    {
+        if constexpr (std::is_same_v<computation_type, long double>)
+        {
+            // guess from double precision, two more steps reach extended precision
+            return rsqrt_newton<long double>(x, rsqrt_positive<double>(static_cast<double>(x)), 2);
+        }
+        else
+        {
+            using traits = rsqrt_traits<computation_type>;
+            using integer_type = typename traits::integer_type;
+
+            // subnormals are scaled into normal range first, 2^-2k scale gives 2^k on result
+            constexpr computation_type scale = static_cast<computation_type>(1ull << 62);
+            constexpr computation_type scale_rsqrt = static_cast<computation_type>(1ull << 31);
+            const bool subnormal = x < std::numeric_limits<computation_type>::min();
+            const computation_type scaled = subnormal ? x * scale : x;
+
+            const computation_type guess = std::bit_cast<computation_type>(
+                static_cast<integer_type>(traits::magic - (std::bit_cast<integer_type>(scaled) >> 1)));
+            const computation_type result = rsqrt_newton(scaled, guess, traits::iterations);
+            return subnormal ? result * scale_rsqrt : result;
+        }
+    }
 
     //compile-time square root
     template <typename computation_type>
-    computation_type sqrt(computation_type x)
+    constexpr computation_type sqrt(computation_type x)
     {
-    	return x >= 0 && x < std::numeric_limits<computation_type>::infinity()
-    		? sqrtNewtonRaphson(x, x, (computation_type)0)
-    		: std::numeric_limits<computation_type>::quiet_NaN();
+        if (!(x > 0 && x < std::numeric_limits<computation_type>::infinity()))
+            return x == 0 || x == std::numeric_limits<computation_type>::infinity()
+                ? x
+                : std::numeric_limits<computation_type>::quiet_NaN();
+
+        // one Heron step on x/sqrt(x) restores last bits lost by multiplication
+        const computation_type root = x * rsqrt_positive(x);
+        return static_cast<computation_type>(0.5) * (root + x / root);
     }
 
-    // compile-time factorial
-    template<std::size_t number>
-    constexpr std::size_t factorial()
+    //compile-time reciprocal square root
+    template <typename computation_type>
+    constexpr computation_type rsqrt(computation_type x)
     {
-        return number * factorial<number-1>();
+        if (!(x > 0 && x < std::numeric_limits<computation_type>::infinity()))
+            return x == 0
+                ? std::numeric_limits<computation_type>::infinity()
+                : x == std::numeric_limits<computation_type>::infinity()
+                    ? 0
+                    : std::numeric_limits<computation_type>::quiet_NaN();
+
+        return rsqrt_positive(x);
     }
-    template<>
-    constexpr std::size_t factorial<0>()
+
+    // reference functions for table fitting: series summed by term recurrence until terms stop
+    // changing the sum, so cost grows with precision of computation_type, not with template depth
+
+    // reduced arguments make terms shrink at least 4 times per step, so 32 steps
+    // exceed precision of every fitting type
+    inline constexpr int series_max_terms = 32;
+
+    template<typename computation_type>
+    constexpr computation_type abs(computation_type x)
     {
-        return 1;
+        return x < 0 ? -x : x;
     }
 
-    //compile-time Tailor series for cosine
-    template<typename computation_type, std::size_t n> 
-    constexpr computation_type cos_tailor(computation_type x)
+    //compile-time sine and cosine of x with |x| < 2^20
+    // x is reduced modulo 2*pi and halved to |r| <= 1/4, sin r and versine 1 - cos r are summed
+    // there, then doubled back by sin 2a = 2 sin a (1 - v(a)), v(2a) = 2 sin^2 a, which keeps
+    // small values accurate; each doubling costs at most one ulp.
+    // Reduction by two part 2*pi is exact for double and wider types up to 2^20 only,
+    // fitting references take arguments of a few turns; larger arguments need Payne-Hanek
+    // reduction of range_reduction.h
+    template<typename computation_type>
+    constexpr void sincos(computation_type x, computation_type& sin, computation_type& cos)
     {
-        return pow<computation_type, n>(-1) 
-            * pow<computation_type, n*2>(x) 
-            / static_cast<computation_type>(factorial<n*2>()) 
-            + cos_tailor<computation_type, n-1>(x);
+        assert(abs(x) < static_cast<computation_type>(0x1p20));
+
+        // 2*pi split in two, first part with 32 bits, so n * first is exact for moderate n
+        constexpr long double two_pi_high = 6.28318530717958647692528676655900577l;
+        constexpr computation_type two_pi_first = static_cast<computation_type>(
+            static_cast<long double>(static_cast<std::uint64_t>(two_pi_high * (1ull << 29))) / (1ull << 29));
+        constexpr computation_type two_pi_second = static_cast<computation_type>(two_pi_high - two_pi_first);
+
+        const computation_type turns = x / (two_pi_first + two_pi_second);
+        // far outside domain turns are kept as they are, so release builds never overflow the conversion
+        const computation_type n = abs(turns) < static_cast<computation_type>(0x1p52)
+            ? static_cast<computation_type>(static_cast<std::int64_t>(turns < 0 ? turns - 0.5 : turns + 0.5))
+            : turns;
+        computation_type r = (x - n * two_pi_first) - n * two_pi_second;
+
+        int doublings = 0;
+        while (abs(r) > static_cast<computation_type>(0.25))
+        {
+            r /= 2;
+            ++doublings;
+        }
+
+        // sin r = sum (-1)^k r^(2k+1) / (2k+1)!, 1 - cos r = sum (-1)^k r^(2k+2) / (2k+2)!
+        const computation_type r2 = r * r;
+        computation_type sin_term = r;
+        computation_type versine_term = r2 / 2;
+        computation_type sin_sum = sin_term;
+        computation_type versine_sum = versine_term;
+        for (int k = 1; k < series_max_terms; ++k)
+        {
+            sin_term *= -r2 / static_cast<computation_type>((2*k) * (2*k + 1));
+            versine_term *= -r2 / static_cast<computation_type>((2*k + 1) * (2*k + 2));
+            const computation_type next_sin = sin_sum + sin_term;
+            const computation_type next_versine = versine_sum + versine_term;
+            if (next_sin == sin_sum && next_versine == versine_sum)
+                break;
+            sin_sum = next_sin;
+            versine_sum = next_versine;
+        }
+
+        for (int i = 0; i < doublings; ++i)
+        {
+            const computation_type doubled_versine = 2 * sin_sum * sin_sum;
+            sin_sum = 2 * sin_sum * (1 - versine_sum);
+            versine_sum = doubled_versine;
+        }
+        sin = sin_sum;
+        cos = 1 - versine_sum;
     }
-    template<>
-    constexpr double cos_tailor<double, 0>(double x)
+
+    template<typename computation_type>
+    constexpr computation_type sin(computation_type x)
     {
-        return 1.0;
+        computation_type sin_value{};
+        computation_type cos_value{};
+        sincos(x, sin_value, cos_value);
+        return sin_value;
     }
-    template<>
-    constexpr float cos_tailor<float, 0>(float x)
+
+    template<typename computation_type>
+    constexpr computation_type cos(computation_type x)
     {
-        return 1.0f;
+        computation_type sin_value{};
+        computation_type cos_value{};
+        sincos(x, sin_value, cos_value);
+        return cos_value;
     }
 
-    //compile-time Tailor series for arcsin
-    template<typename computation_type, std::size_t n>
-    constexpr computation_type asin_tailor(computation_type x)
+    //compile-time arcsine, x in [-1, 1]
+    // series for |x| <= 1/2, asin x = pi/2 - 2 asin(sqrt((1 - x) / 2)) above, where the series
+    // converges slowly; 1 - x is exact there, so values near 1 keep full precision
+    template<typename computation_type>
+    constexpr computation_type asin(computation_type x)
     {
-        return factorial<2*n>() * pow<computation_type, 2*n + 1>(x)
-            / (pow<computation_type, n>(4) * pow<std::size_t, 2>(factorial<n>()) * (2*n + 1))
-            + asin_tailor<computation_type, n-1>(x);
+        constexpr computation_type pi_2 = static_cast<computation_type>(1.57079632679489661923132169163975144l);
+        // fitting nodes may round a little past 1
+        const computation_type magnitude = abs(x) < 1 ? abs(x) : computation_type(1);
+        const bool reflected = magnitude > static_cast<computation_type>(0.5);
+        const computation_type w = reflected ? sqrt((1 - magnitude) / 2) : magnitude;
+
+        // asin w = sum (2k)! / (4^k (k!)^2 (2k+1)) w^(2k+1), term ratio (2k+1)^2 w^2 / ((2k+2)(2k+3))
+        const computation_type w2 = w * w;
+        computation_type power_term = w;
+        computation_type sum = w;
+        for (int k = 0; k < series_max_terms; ++k)
+        {
+            power_term *= w2 * static_cast<computation_type>(2*k + 1) / static_cast<computation_type>(2*k + 2);
+            const computation_type next = sum + power_term / static_cast<computation_type>(2*k + 3);
+            if (next == sum)
+                break;
+            sum = next;
+        }
+
+        const computation_type result = reflected ? pi_2 - 2 * sum : sum;
+        return x < 0 ? -result : result;
     }
-    template<>
-    constexpr double asin_tailor<double, 0>(double x)
+}
+
+/// \brief square root and reciprocal square root
+/// constant evaluation uses bounded Newton-Raphson iteration from _math_helper,
+/// at runtime hardware square root is used
+namespace fast_math
+{
+    template<typename computation_type>
+    constexpr computation_type sqrt(computation_type x)
     {
-        return x;
+        if (std::is_constant_evaluated())
+            return _math_helper::sqrt(x);
+        return std::sqrt(x);
     }
-    template<>
-    constexpr float asin_tailor<float, 0>(float x)
+
+    template<typename computation_type>
+    constexpr computation_type rsqrt(computation_type x)
     {
-        return x;
+        if (std::is_constant_evaluated())
+            return _math_helper::rsqrt(x);
+        return 1 / std::sqrt(x);
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,334 @@
+#pragma once
+
+#include "simd.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+/// \brief Opt-in call counters and argument histograms of trigonometry
+/// With TRIGONOMETRY_INSTRUMENTATION defined every scalar and batch call of trigonometry counts
+/// itself and its arguments in counters of calling thread, without locks or shared cache lines.
+/// 'collect' merges counters of running and finished threads into a report, e.g. to find hot
+/// functions and argument ranges (do cos arguments leave [-2pi, 2pi]?) before picking
+/// polynomial sizes per call site. Without the define recording compiles to nothing.
+namespace instrumentation
+{
+#if defined(TRIGONOMETRY_INSTRUMENTATION)
+    constexpr bool enabled = true;
+#else
+    constexpr bool enabled = false;
+#endif
+
+    /// \brief instrumented functions of trigonometry
+    enum class function : std::uint32_t
+    {
+        cos,
+        sin,
+        sincos,
+        tan,
+        asin,
+        acos,
+        atan,
+        atan2,
+        count
+    };
+
+    constexpr std::size_t function_count = static_cast<std::size_t>(function::count);
+
+    inline const char* function_name(function id)
+    {
+        constexpr const char* names[function_count] = {"cos", "sin", "sincos", "tan", "asin", "acos", "atan", "atan2"};
+        return names[static_cast<std::size_t>(id)];
+    }
+
+    /// histogram buckets by binary exponent of |x|: bucket 0 holds |x| < 2^min_exponent (zero included),
+    /// bucket k holds [2^(min_exponent + k - 1), 2^(min_exponent + k)), last bucket holds
+    /// |x| >= 2^max_exponent, infinity and NaN
+    constexpr int min_exponent = -32;
+    constexpr int max_exponent = 32;
+    constexpr std::size_t bucket_count = max_exponent - min_exponent + 2;
+
+    inline std::size_t bucket(double x)
+    {
+        const double magnitude = std::fabs(x);
+        if (!(magnitude < std::ldexp(1.0, max_exponent)))
+            return bucket_count - 1;
+        if (magnitude < std::ldexp(1.0, min_exponent))
+            return 0;
+        return static_cast<std::size_t>(std::ilogb(magnitude) - min_exponent + 1);
+    }
+
+    /// \brief smallest |x| of bucket
+    inline double bucket_lower_bound(std::size_t index)
+    {
+        return index == 0 ? 0.0 : std::ldexp(1.0, min_exponent + static_cast<int>(index) - 1);
+    }
+
+    /// \brief merged counters of one function
+    /// atan2 records both coordinates, so it has twice as many arguments as calls
+    struct function_statistics
+    {
+        std::uint64_t calls = 0;        ///< scalar calls and batch elements, so scalar loops and batches compare
+        std::uint64_t batch_calls = 0;  ///< batch calls, parallel batches count once
+        std::uint64_t arguments = 0;    ///< scalar arguments and batch elements
+        double min_argument = std::numeric_limits<double>::infinity();
+        double max_argument = -std::numeric_limits<double>::infinity();
+        std::array<std::uint64_t, bucket_count> histogram{};
+    };
+
+    /// \brief counters of all threads merged by collect
+    struct report
+    {
+        std::array<function_statistics, function_count> functions{};
+
+        const function_statistics& operator[](function id) const { return functions[static_cast<std::size_t>(id)]; }
+
+        /// \brief functions with calls, histogram as list of non-empty buckets
+        /// numbers round trip (max_digits10), infinite and NaN arguments are written as strings "inf", "-inf" and "nan"
+        void write_json(std::ostream& o_stream) const
+        {
+            const std::streamsize precision = o_stream.precision(std::numeric_limits<double>::max_digits10);
+            o_stream<<"{"<<std::endl<<"  \"functions\": [";
+            bool first_function = true;
+            for (std::size_t f = 0; f < function_count; ++f)
+            {
+                const function_statistics& s = functions[f];
+                if (s.calls == 0)
+                    continue;
+                o_stream<<(first_function ? "" : ",")<<std::endl<<"    {\"function\": \""<<function_name(static_cast<function>(f))
+                    <<"\", \"calls\": "<<s.calls<<", \"batch_calls\": "<<s.batch_calls<<", \"arguments\": "<<s.arguments;
+                if (s.min_argument <= s.max_argument)
+                {
+                    o_stream<<", \"min_argument\": ";
+                    write_number(o_stream, s.min_argument);
+                    o_stream<<", \"max_argument\": ";
+                    write_number(o_stream, s.max_argument);
+                }
+                o_stream<<", \"histogram\": [";
+                bool first_bucket = true;
+                for (std::size_t b = 0; b < bucket_count; ++b)
+                {
+                    if (s.histogram[b] == 0)
+                        continue;
+                    o_stream<<(first_bucket ? "" : ", ")<<"{\"min_magnitude\": "<<bucket_lower_bound(b)<<", \"count\": "<<s.histogram[b]<<"}";
+                    first_bucket = false;
+                }
+                o_stream<<"]}";
+                first_function = false;
+            }
+            o_stream<<std::endl<<"  ]"<<std::endl<<"}"<<std::endl;
+            o_stream.precision(precision);
+        }
+
+    private:
+        /// JSON has no literals for infinity and NaN
+        static void write_number(std::ostream& o_stream, double value)
+        {
+            if (std::isnan(value))
+                o_stream<<"\"nan\"";
+            else if (std::isinf(value))
+                o_stream<<(value < 0 ? "\"-inf\"" : "\"inf\"");
+            else
+                o_stream<<value;
+        }
+    };
+}
+
+namespace _instrumentation_detail
+{
+    using instrumentation::bucket_count;
+    using instrumentation::function;
+    using instrumentation::function_count;
+    using instrumentation::function_statistics;
+    using instrumentation::report;
+
+    /// counters of one thread: only owner writes, collect reads while owner runs,
+    /// so relaxed load and store replace atomic read-modify-write
+    struct thread_counters
+    {
+        struct function_counters
+        {
+            std::atomic<std::uint64_t> calls{0};
+            std::atomic<std::uint64_t> batch_calls{0};
+            std::atomic<std::uint64_t> arguments{0};
+            std::atomic<double> min_argument{std::numeric_limits<double>::infinity()};
+            std::atomic<double> max_argument{-std::numeric_limits<double>::infinity()};
+            std::array<std::atomic<std::uint64_t>, bucket_count> histogram{};
+        };
+
+        std::array<function_counters, function_count> functions;
+    };
+
+    inline void add(std::atomic<std::uint64_t>& counter, std::uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    inline void record_argument(thread_counters::function_counters& counters, double x)
+    {
+        add(counters.arguments, 1);
+        add(counters.histogram[instrumentation::bucket(x)], 1);
+        if (x < counters.min_argument.load(std::memory_order_relaxed))
+            counters.min_argument.store(x, std::memory_order_relaxed);
+        if (x > counters.max_argument.load(std::memory_order_relaxed))
+            counters.max_argument.store(x, std::memory_order_relaxed);
+    }
+
+    inline void merge(const thread_counters::function_counters& counters, function_statistics& o_statistics)
+    {
+        o_statistics.calls += counters.calls.load(std::memory_order_relaxed);
+        o_statistics.batch_calls += counters.batch_calls.load(std::memory_order_relaxed);
+        o_statistics.arguments += counters.arguments.load(std::memory_order_relaxed);
+        o_statistics.min_argument = std::min(o_statistics.min_argument, counters.min_argument.load(std::memory_order_relaxed));
+        o_statistics.max_argument = std::max(o_statistics.max_argument, counters.max_argument.load(std::memory_order_relaxed));
+        for (std::size_t b = 0; b < bucket_count; ++b)
+            o_statistics.histogram[b] += counters.histogram[b].load(std::memory_order_relaxed);
+    }
+
+    inline void clear(thread_counters::function_counters& counters)
+    {
+        counters.calls.store(0, std::memory_order_relaxed);
+        counters.batch_calls.store(0, std::memory_order_relaxed);
+        counters.arguments.store(0, std::memory_order_relaxed);
+        counters.min_argument.store(std::numeric_limits<double>::infinity(), std::memory_order_relaxed);
+        counters.max_argument.store(-std::numeric_limits<double>::infinity(), std::memory_order_relaxed);
+        for (auto& count : counters.histogram)
+            count.store(0, std::memory_order_relaxed);
+    }
+
+    /// counters of running threads and merged counters of finished ones
+    struct registry
+    {
+        std::mutex mutex;
+        std::vector<thread_counters*> live;
+        report retired;
+    };
+
+    inline registry& global_registry()
+    {
+        static registry instance;
+        return instance;
+    }
+
+    /// registers counters of its thread, merges them into retired counters when thread ends
+    class thread_slot {
+    public:
+        thread_slot() : mRegistry(global_registry())
+        {
+            std::lock_guard<std::mutex> lock(mRegistry.mutex);
+            mRegistry.live.push_back(&mCounters);
+        }
+
+        thread_slot(const thread_slot&) = delete;
+        thread_slot& operator=(const thread_slot&) = delete;
+
+        ~thread_slot()
+        {
+            std::lock_guard<std::mutex> lock(mRegistry.mutex);
+            for (std::size_t f = 0; f < function_count; ++f)
+                merge(mCounters.functions[f], mRegistry.retired.functions[f]);
+            std::erase(mRegistry.live, &mCounters);
+        }
+
+        thread_counters& counters() { return mCounters; }
+
+    private:
+        registry& mRegistry;
+        thread_counters mCounters;
+    };
+
+    inline thread_counters::function_counters& local_counters(function id)
+    {
+        thread_local thread_slot slot;
+        return slot.counters().functions[static_cast<std::size_t>(id)];
+    }
+}
+
+namespace instrumentation
+{
+    /// \brief counts one scalar call of 'id' and its arguments in counters of calling thread
+    /// compiles to nothing without TRIGONOMETRY_INSTRUMENTATION and in constant evaluation
+    template<typename... argument_types>
+    TRIGONOMETRY_FORCE_INLINE constexpr void record(function id, argument_types... x)
+    {
+        if constexpr (enabled)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                auto& counters = _instrumentation_detail::local_counters(id);
+                _instrumentation_detail::add(counters.calls, 1);
+                (_instrumentation_detail::record_argument(counters, static_cast<double>(x)), ...);
+            }
+        }
+    }
+
+    /// \brief counts elements of batch arrays of 'id' as calls and their arguments, without a batch call;
+    /// chunks of parallel batches record this way on their threads.
+    /// Elements are converted to 'computation_type' as batch kernels do, arrays are of same length
+    template<typename computation_type, typename first_storage_type, typename... storage_types>
+    void record_elements(function id, std::span<const first_storage_type> first, std::span<const storage_types>... x)
+    {
+        if constexpr (enabled)
+        {
+            auto& counters = _instrumentation_detail::local_counters(id);
+            _instrumentation_detail::add(counters.calls, first.size());
+            const auto record_arguments = [&](auto elements)
+            {
+                for (const auto& element : elements)
+                    _instrumentation_detail::record_argument(counters, static_cast<double>(simd::convert<computation_type>(element)));
+            };
+            record_arguments(first);
+            (record_arguments(x), ...);
+        }
+    }
+
+    /// \brief counts one batch call of 'id', its elements are recorded by record_elements
+    inline void record_batch_call(function id)
+    {
+        if constexpr (enabled)
+            _instrumentation_detail::add(_instrumentation_detail::local_counters(id).batch_calls, 1);
+    }
+
+    /// \brief counts one batch call of 'id' and every element of its argument arrays as record_elements
+    template<typename computation_type, typename... storage_types>
+    void record_batch(function id, std::span<const storage_types>... x)
+    {
+        record_batch_call(id);
+        record_elements<computation_type>(id, x...);
+    }
+
+    /// \brief merged counters of all threads that recorded, running and finished
+    /// counts of running threads are as recent as their last relaxed stores
+    inline report collect()
+    {
+        _instrumentation_detail::registry& registry = _instrumentation_detail::global_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        report result = registry.retired;
+        for (const _instrumentation_detail::thread_counters* counters : registry.live)
+            for (std::size_t f = 0; f < function_count; ++f)
+                _instrumentation_detail::merge(counters->functions[f], result.functions[f]);
+        return result;
+    }
+
+    /// \brief clears counters of all threads
+    /// threads recording meanwhile may keep part of counts made before reset
+    inline void reset()
+    {
+        _instrumentation_detail::registry& registry = _instrumentation_detail::global_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.retired = report{};
+        for (_instrumentation_detail::thread_counters* counters : registry.live)
+            for (auto& function_counters : counters->functions)
+                _instrumentation_detail::clear(function_counters);
+    }
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__)
+#include <unistd.h>
+#endif
+
+/// \brief Thread pool for bulk operations on large arrays
+namespace parallel
+{
+    /// \brief size of L2 cache of running CPU in bytes, 1 MiB when it is not reported
+    inline std::size_t l2_cache_size()
+    {
+        static const std::size_t size = []() -> std::size_t
+        {
+#if defined(_SC_LEVEL2_CACHE_SIZE)
+            const long reported = sysconf(_SC_LEVEL2_CACHE_SIZE);
+            if (reported > 0)
+                return static_cast<std::size_t>(reported);
+#endif
+            return std::size_t(1) << 20;
+        }();
+        return size;
+    }
+
+    /// \brief elements per chunk so that 'streams' arrays of chunk fit into half of L2 cache
+    /// other half is left for coefficient tables, stack and prefetched lines
+    template<typename type>
+    std::size_t chunk_size(std::size_t streams)
+    {
+        constexpr std::size_t min_chunk_size = 4096;
+        return std::max(min_chunk_size, l2_cache_size() / 2 / (streams * sizeof(type)));
+    }
+
+    /// \brief fixed set of threads executing one chunked loop at a time
+    /// Chunks are split between threads in contiguous ranges proportional to position in array,
+    /// every thread works through its own range first and then steals chunks from others.
+    /// Threads are not pinned to cores and stolen chunks go to any thread, so no chunk is bound to a thread.
+    /// Calling thread takes part in work; loops are serialized, tasks must not start loops themselves.
+    class thread_pool {
+    public:
+        explicit thread_pool(unsigned thread_count = std::max(1u, std::thread::hardware_concurrency())) :
+            mRanges(std::make_unique<chunk_range[]>(std::max(1u, thread_count))),
+            mThreadCount(std::max(1u, thread_count))
+        {
+            for (unsigned index = 1; index < mThreadCount; ++index)
+                mThreads.emplace_back([this, index] { worker_loop(index); });
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        ~thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mStopping = true;
+                ++mGeneration;
+            }
+            mWake.notify_all();
+            for (auto& thread : mThreads)
+                thread.join();
+        }
+
+        /// \brief number of threads including calling one
+        unsigned thread_count() const { return mThreadCount; }
+
+        /// \brief calls task(begin, end) for consecutive chunks of [0, count), returns when all are done
+        /// \param task: callable, void(std::size_t begin, std::size_t end)
+        template<typename task_type>
+        void for_each_chunk(std::size_t count, std::size_t chunk_size, const task_type& task)
+        {
+            if (count == 0)
+                return;
+            const std::size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+            if (mThreadCount == 1 || chunk_count == 1)
+            {
+                for (std::size_t begin = 0; begin < count; begin += chunk_size)
+                    task(begin, std::min(count, begin + chunk_size));
+                return;
+            }
+
+            std::lock_guard<std::mutex> loop_lock(mLoopMutex);
+            mCount = count;
+            mChunkSize = chunk_size;
+            mTask = &task;
+            mInvoke = [](const void* task, std::size_t begin, std::size_t end)
+            {
+                (*static_cast<const task_type*>(task))(begin, end);
+            };
+            for (unsigned index = 0; index < mThreadCount; ++index)
+            {
+                mRanges[index].next.store(chunk_count * index / mThreadCount, std::memory_order_relaxed);
+                mRanges[index].end = chunk_count * (index + 1) / mThreadCount;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mBusy = mThreadCount - 1;
+                ++mGeneration;
+            }
+            mWake.notify_all();
+
+            work(0);
+
+            std::unique_lock<std::mutex> lock(mMutex);
+            mDone.wait(lock, [this] { return mBusy == 0; });
+        }
+
+    private:
+        struct alignas(64) chunk_range
+        {
+            std::atomic<std::size_t> next{0};
+            std::size_t end = 0;
+        };
+
+        using invoke_function = void (*)(const void* task, std::size_t begin, std::size_t end);
+
+        void worker_loop(unsigned index)
+        {
+            std::size_t seen_generation = 0;
+            for (;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(mMutex);
+                    mWake.wait(lock, [&] { return mGeneration != seen_generation; });
+                    seen_generation = mGeneration;
+                    if (mStopping)
+                        return;
+                }
+
+                work(index);
+
+                bool last = false;
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    last = --mBusy == 0;
+                }
+                if (last)
+                    mDone.notify_one();
+            }
+        }
+
+        /// own range first, then other ranges in order, starting after own one
+        void work(unsigned index)
+        {
+            for (unsigned offset = 0; offset < mThreadCount; ++offset)
+            {
+                chunk_range& range = mRanges[(index + offset) % mThreadCount];
+                for (std::size_t chunk = range.next++; chunk < range.end; chunk = range.next++)
+                {
+                    const std::size_t begin = chunk * mChunkSize;
+                    mInvoke(mTask, begin, std::min(mCount, begin + mChunkSize));
+                }
+            }
+        }
+
+        std::unique_ptr<chunk_range[]> mRanges;
+        std::vector<std::thread> mThreads;
+        unsigned mThreadCount;
+
+        std::mutex mLoopMutex;
+        std::mutex mMutex;
+        std::condition_variable mWake;
+        std::condition_variable mDone;
+        std::size_t mGeneration = 0;
+        unsigned mBusy = 0;
+        bool mStopping = false;
+
+        std::size_t mCount = 0;
+        std::size_t mChunkSize = 0;
+        const void* mTask = nullptr;
+        invoke_function mInvoke = nullptr;
+    };
+
+    /// \brief pool with one thread per hardware thread, created on first use
+    inline thread_pool& default_thread_pool()
+    {
+        static thread_pool pool;
+        return pool;
+    }
+
+    /// \brief value-initializes data chunk by chunk on all threads of pool
+    /// faults pages of freshly allocated arrays in parallel instead of inside first measured loop;
+    /// page placement follows scheduling of pool, no particular node is guaranteed
+    template<typename type>
+    void first_touch(thread_pool& pool, std::span<type> data, std::size_t chunk_size)
+    {
+        pool.for_each_chunk(data.size(), chunk_size, [data](std::size_t begin, std::size_t end)
+        {
+            std::fill(data.begin() + begin, data.begin() + end, type{});
+        });
+    }
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "polynomial.h"
+#include "simd.h"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+/// \brief Piecewise polynomial over [min, max] split into 'segments' equal segments
+/// every segment has its own polynomial of degree 'degree' in local parameter t in [0, 1),
+/// so accuracy is raised by adding segments instead of raising degree.
+/// Coefficients are stored structure of arrays (one cache line aligned row per power),
+/// segment index is sliced from mantissa bits of scaled argument, see segment_index.
+/// Arguments outside [min, max] are extrapolated by first and last segment.
+template<typename type, std::size_t degree, std::size_t segments>
+class piecewise_polynomial {
+public:
+    static_assert(segments > 0 && (segments & (segments - 1)) == 0, "segment count must be power of two");
+
+    constexpr static std::size_t coefficient_count = degree + 1;
+
+    using segment_row_type = std::array<type, segments>;
+    using coefficient_table_type = std::array<segment_row_type, coefficient_count>;
+
+protected:
+    /// mCoefficients[power][segment]
+    alignas(64) coefficient_table_type mCoefficients;
+    type mMin;
+    type mScale;
+
+public:
+    piecewise_polynomial() = delete;
+
+    /// \brief initializes piecewise polynomial with coefficient table over [min, max]
+    constexpr piecewise_polynomial(const coefficient_table_type& coefficients, type min, type max) :
+        mCoefficients(coefficients),
+        mMin(min),
+        mScale(static_cast<type>(segments) / (max - min))
+    {
+    }
+
+    /// \brief returns coefficient table, mCoefficients[power][segment]
+    constexpr const coefficient_table_type& getCoefficients() const { return mCoefficients; }
+
+    /// \brief calculates value in given x
+    constexpr type evaluate(type x) const
+    {
+        const type scaled = (x - mMin) * mScale;
+        const std::size_t index = static_cast<std::size_t>(segment_index(scaled));
+        // NaN stays NaN through t
+        const type t = scaled - static_cast<type>(index);
+
+        type result = mCoefficients[degree][index];
+        for (std::size_t power = degree; power-- > 0;)
+            result = result * t + mCoefficients[power][index];
+        return result;
+    }
+
+    /// \brief calculates values in every lane of simd pack x
+    template<typename value_type>
+        requires (!std::is_arithmetic_v<value_type>)
+    TRIGONOMETRY_FORCE_INLINE constexpr value_type evaluate(const value_type& x) const
+    {
+        const value_type scaled = (x - mMin) * mScale;
+        const auto index = segment_index(scaled);
+        const value_type t = scaled - simd::lane_cast<type>(index);
+
+        value_type result = gather<value_type>(degree, index);
+        for (std::size_t power = degree; power-- > 0;)
+            result = result * t + gather<value_type>(power, index);
+        return result;
+    }
+
+    constexpr type operator() (type x) const
+    {
+        return evaluate(x);
+    }
+
+    template<typename value_type>
+        requires (!std::is_arithmetic_v<value_type>)
+    TRIGONOMETRY_FORCE_INLINE constexpr value_type operator() (const value_type& x) const
+    {
+        return evaluate(x);
+    }
+
+    /// \brief Interpolates function on every segment by polynomial::interpolate
+    /// nodes are placed by 'node_policy', fitting is done in long double
+    /// \param function: callable, long double(long double)
+    template<typename node_policy = polynomial_nodes::chebyshev, typename function_type>
+    constexpr static piecewise_polynomial interpolate(const function_type& function, type min, type max)
+    {
+        using fit_type = long double;
+        const fit_type start = min;
+        const fit_type segment_length = (static_cast<fit_type>(max) - start) / segments;
+
+        coefficient_table_type coefficients{};
+        for (std::size_t segment = 0; segment < segments; ++segment)
+        {
+            const fit_type segment_start = start + segment_length * segment;
+            const auto local_function = [&](fit_type t) { return static_cast<fit_type>(function(segment_start + segment_length * t)); };
+            const auto local = polynomial<fit_type, coefficient_count>::template interpolate<node_policy>(local_function, 0, 1);
+
+            for (std::size_t power = 0; power < coefficient_count; ++power)
+                coefficients[power][segment] = static_cast<type>(local.getCoefficients()[power]);
+        }
+        return piecewise_polynomial(coefficients, min, max);
+    }
+
+    /// \brief Best uniform approximation of function on every segment by polynomial::fit_minimax
+    /// \param function: callable, long double(long double)
+    template<typename function_type>
+    constexpr static piecewise_polynomial fit_minimax(const function_type& function, type min, type max)
+    {
+        using fit_type = long double;
+        const fit_type start = min;
+        const fit_type segment_length = (static_cast<fit_type>(max) - start) / segments;
+
+        coefficient_table_type coefficients{};
+        for (std::size_t segment = 0; segment < segments; ++segment)
+        {
+            const fit_type segment_start = start + segment_length * segment;
+            const auto local_function = [&](fit_type t) { return static_cast<fit_type>(function(segment_start + segment_length * t)); };
+            const auto local = polynomial<fit_type, coefficient_count>::fit_minimax(local_function, 0, 1);
+
+            for (std::size_t power = 0; power < coefficient_count; ++power)
+                coefficients[power][segment] = static_cast<type>(local.getCoefficients()[power]);
+        }
+        return piecewise_polynomial(coefficients, min, max);
+    }
+
+private:
+    using bits_type = std::conditional_t<sizeof(type) == 4, std::int32_t, std::int64_t>;
+
+    /// \brief segment of scaled argument in [0, segments) from its bits, as integer of type's width
+    /// 1 + scaled / segments lies in [1, 2) where exponent is fixed, so top log2(segments) mantissa
+    /// bits are the segment. Values below 0 and NaN go to first segment, values above to last
+    template<typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr static auto segment_index(const value_type& scaled)
+    {
+        constexpr int mantissa_bits = std::numeric_limits<type>::digits - 1;
+        constexpr int segment_bits = std::countr_zero(segments);
+        constexpr type below_two = 2 - std::numeric_limits<type>::epsilon();
+        constexpr bits_type segment_mask = static_cast<bits_type>(segments - 1);
+
+        value_type unit = scaled * (static_cast<type>(1) / segments) + 1;
+        unit = simd::select(unit >= 1, unit, simd::broadcast<value_type>(1));
+        unit = simd::select(unit < 2, unit, simd::broadcast<value_type>(below_two));
+        return (simd::reinterpret_lanes<bits_type>(unit) >> (mantissa_bits - segment_bits)) & segment_mask;
+    }
+
+    /// \brief coefficient of given power for segment in every lane of index
+    template<typename value_type, typename index_type>
+    TRIGONOMETRY_FORCE_INLINE value_type gather(std::size_t power, const index_type& index) const
+    {
+        value_type result{};
+        simd::gather(mCoefficients[power].data(), index, result);
+        return result;
+    }
+};
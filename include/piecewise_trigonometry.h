@@ -0,0 +1,172 @@
+#pragma once
+
+#include "helper_math.h"
+#include "piecewise_polynomial.h"
+#include "range_reduction.h"
+#include "simd.h"
+#include "trigonometry.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+namespace _piecewise_detail
+{
+    using fit_type = _math_detail::fit_type;
+
+    constexpr fit_type pi_4 = 0.785398163397448309615660845819875721l;
+
+    /// octant tables in r on [-pi/4, pi/4], not in r^2: segments split angles evenly
+    template<typename computation_type, std::size_t degree, std::size_t segments>
+    inline constexpr auto cos_table = piecewise_polynomial<computation_type, degree, segments>::interpolate(
+        [](fit_type r) { return _math_detail::cos_sqrt_reference(r * r); }, static_cast<computation_type>(-pi_4), static_cast<computation_type>(pi_4));
+
+    template<typename computation_type, std::size_t degree, std::size_t segments>
+    inline constexpr auto sin_table = piecewise_polynomial<computation_type, degree, segments>::interpolate(
+        [](fit_type r) { return r * _math_detail::sin_sqrt_reference(r * r); }, static_cast<computation_type>(-pi_4), static_cast<computation_type>(pi_4));
+
+    /// asin on [0, 1/2], larger arguments are folded into it by asin_kernel
+    template<typename computation_type, std::size_t degree, std::size_t segments>
+    inline constexpr auto asin_table = piecewise_polynomial<computation_type, degree, segments>::interpolate(
+        [](fit_type x) { return _math_helper::asin(x); }, static_cast<computation_type>(0), static_cast<computation_type>(0.5));
+
+    template<typename computation_type, std::size_t degree, std::size_t segments>
+    struct sincos_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static void apply(const value_type& x, value_type& sin, value_type& cos)
+        {
+            value_type r{};
+            value_type quadrant{};
+            _math_detail::reduce_quadrant<computation_type>(x, r, quadrant);
+            _math_detail::sincos_from_octant<computation_type>(quadrant, sin_table<computation_type, degree, segments>(r),
+                cos_table<computation_type, degree, segments>(r), sin, cos);
+        }
+    };
+
+    template<typename computation_type, std::size_t degree, std::size_t segments>
+    struct cos_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static value_type apply(const value_type& x)
+        {
+            value_type r{};
+            value_type quadrant{};
+            _math_detail::reduce_quadrant<computation_type>(x, r, quadrant);
+            // cos of quadrant 0, 1, 2, 3 is cos, -sin, -cos, sin of reduced argument: only one table is evaluated,
+            // one comparison per condition as in sincos_from_octant
+            constexpr computation_type half = 0.5;
+            const auto odd = simd::abs(simd::abs(quadrant - 2) - 1) < half;
+            const value_type value = simd::select(odd, sin_table<computation_type, degree, segments>(r),
+                cos_table<computation_type, degree, segments>(r));
+            return simd::select(simd::abs(quadrant - (1 + half)) < 1, -value, value);
+        }
+    };
+
+    template<typename computation_type, std::size_t degree, std::size_t segments>
+    struct sin_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static value_type apply(const value_type& x)
+        {
+            value_type sin{};
+            value_type cos{};
+            sincos_kernel<computation_type, degree, segments>::apply(x, sin, cos);
+            return sin;
+        }
+    };
+
+    template<typename computation_type, std::size_t degree, std::size_t segments>
+    struct asin_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static value_type apply(const value_type& x)
+        {
+            // asin(a) = pi/2 - 2 asin(sqrt((1 - a) / 2)) above 1/2 keeps table away from infinite slope at 1
+            constexpr computation_type half = 0.5;
+            constexpr computation_type pi_two = M_PI_2;
+            const value_type a = simd::abs(x);
+            const auto inside = a <= 1;
+            const auto folded = a > half;
+            const value_type fold_square = simd::select(inside, (1 - a) * half, simd::broadcast<value_type>(0));
+            value_type fold{};
+            if constexpr (std::is_arithmetic_v<value_type>)
+                fold = fast_math::sqrt(fold_square);
+            else
+                fold = simd::sqrt(fold_square);
+
+            const value_type table = asin_table<computation_type, degree, segments>(simd::select(folded, fold, a));
+            const value_type result = simd::copysign(simd::select(folded, pi_two - (table + table), table), x);
+            // outside [-1, 1] asin is NaN as std::asin
+            return simd::select(inside, result, simd::broadcast<value_type>(std::numeric_limits<computation_type>::quiet_NaN()));
+        }
+    };
+
+    template<typename computation_type, std::size_t degree, std::size_t segments>
+    struct acos_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static value_type apply(const value_type& x)
+        {
+            constexpr computation_type pi_two = M_PI_2;
+            return pi_two - asin_kernel<computation_type, degree, segments>::apply(x);
+        }
+    };
+}
+
+/// \brief cos, sin, asin and acos from piecewise polynomial tables of degree 'degree' with 'segments' segments
+/// Low degree kernels on an L1 resident table trade table size for latency, accuracy grows with segments.
+/// sin/cos use reduction of trigonometry and octant tables on [-pi/4, pi/4]; asin folds |x| > 1/2 by
+/// asin(x) = pi/2 - 2 asin(sqrt((1 - x) / 2)) into a table on [0, 1/2] and is NaN outside [-1, 1].
+/// Batch versions have contracts of trigonometry batch versions.
+template<typename computation_type, std::size_t degree, std::size_t segments, typename storage_type = computation_type,
+    typename result_storage_type = storage_type>
+struct piecewise_trigonometry
+{
+    constexpr static computation_type cos(computation_type x)
+    {
+        return _piecewise_detail::cos_kernel<computation_type, degree, segments>::apply(x);
+    }
+
+    constexpr static computation_type sin(computation_type x)
+    {
+        return _piecewise_detail::sin_kernel<computation_type, degree, segments>::apply(x);
+    }
+
+    constexpr static computation_type asin(computation_type x)
+    {
+        return _piecewise_detail::asin_kernel<computation_type, degree, segments>::apply(x);
+    }
+
+    constexpr static computation_type acos(computation_type x)
+    {
+        return _piecewise_detail::acos_kernel<computation_type, degree, segments>::apply(x);
+    }
+
+    static void cos(std::span<const storage_type> x, std::span<result_storage_type> result)
+    {
+        assert(result.size() >= x.size());
+        simd::transform<_piecewise_detail::cos_kernel<computation_type, degree, segments>, computation_type>(x.size(), result.data(), x.data());
+    }
+
+    static void sin(std::span<const storage_type> x, std::span<result_storage_type> result)
+    {
+        assert(result.size() >= x.size());
+        simd::transform<_piecewise_detail::sin_kernel<computation_type, degree, segments>, computation_type>(x.size(), result.data(), x.data());
+    }
+
+    static void asin(std::span<const storage_type> x, std::span<result_storage_type> result)
+    {
+        assert(result.size() >= x.size());
+        simd::transform<_piecewise_detail::asin_kernel<computation_type, degree, segments>, computation_type>(x.size(), result.data(), x.data());
+    }
+
+    static void acos(std::span<const storage_type> x, std::span<result_storage_type> result)
+    {
+        assert(result.size() >= x.size());
+        simd::transform<_piecewise_detail::acos_kernel<computation_type, degree, segments>, computation_type>(x.size(), result.data(), x.data());
+    }
+};
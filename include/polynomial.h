@@ -1,124 +1,442 @@
 #pragma once
 
+#include "double_double.h"
 #include "helper_math.h"
+#include "simd.h"
 
 #include <cstddef>
+#include <cmath>
 #include <array>
+#include <bit>
+#include <type_traits>
+#include <span>
+#include <utility>
+#include <vector>
 
+namespace polynomial_detail
+{
+    template<typename computation_type, std::size_t size>
+    using vector = std::array<computation_type, size>;
 
-template<typename computation_type, std::size_t size>
-class polynomial_helper {
-public:
-    typedef std::array<computation_type, size> vector;
-    typedef std::array<vector, size> matrix;
-
+    template<std::size_t power, typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr value_type pow(const value_type& base)
+    {
+        if constexpr (power == 0)
+            return simd::broadcast<value_type>(1);
+        else
+            return base * pow<power-1>(base);
+    }
 
-    constexpr static matrix create_Vandermonde_U_inv(const vector &samples_x) {
-        matrix U_inv;
+    template<typename computation_type, std::size_t size, std::size_t idx>
+    struct evaluate_polynomial
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static value_type value(const vector<computation_type, size>& coefficients, const value_type& param)
+        {
+            return evaluate_polynomial<computation_type, size, idx-1>::value(coefficients, param) 
+                + pow<idx>(param) * coefficients[idx];
+        }
+    };
 
-        // diagonal
-        for (std::size_t i = 0; i < size; i++)
-            U_inv[i][i] = static_cast<computation_type>(1);
+    template<typename computation_type, std::size_t size>
+    struct evaluate_polynomial<computation_type, size, 0>
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static value_type value(const vector<computation_type, size>& coefficients, const value_type& param)
+        {
+            return simd::broadcast<value_type>(coefficients[0]);
+        }
+    };
 
-        // first column
-        for (std::size_t i = 1; i < size; i++)
-            U_inv[i][0] = static_cast<computation_type>(0);
+    /// \brief Estrin's scheme on coefficients [begin, begin+count)
+    /// splits at largest power of two below count: low + x^half * high
+    /// powers[k] is x^(2^k)
+    template<std::size_t begin, std::size_t count, typename computation_type, std::size_t size, typename value_type, std::size_t levels>
+    TRIGONOMETRY_FORCE_INLINE constexpr value_type evaluate_estrin(const std::array<computation_type, size>& coefficients, const std::array<value_type, levels>& powers)
+    {
+        if constexpr (count == 1)
+            return simd::broadcast<value_type>(coefficients[begin]);
+        else if constexpr (count == 2)
+            return powers[0] * coefficients[begin + 1] + coefficients[begin];
+        else
+        {
+            constexpr std::size_t level = std::bit_width(count - 1) - 1;
+            constexpr std::size_t half = std::size_t(1) << level;
+            return evaluate_estrin<begin + half, count - half>(coefficients, powers) * powers[level]
+                + evaluate_estrin<begin, half>(coefficients, powers);
+        }
+    }
 
-        // under diagonal
-        for (std::size_t i = 2; i < size; i++) {
-            for (std::size_t j = 1; j < i; j++) {
-                U_inv[i][j] = static_cast<computation_type>(0);
+    /// \brief p(x) and p'(x) by Horner, derivative chain follows value chain one step behind
+    template<typename type, std::size_t size, typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr std::pair<value_type, value_type> evaluate_with_derivative(const std::array<type, size>& coefficients, const value_type& x)
+    {
+        value_type value = simd::broadcast<value_type>(coefficients[size-1]);
+        if constexpr (size < 2)
+            return { value, simd::broadcast<value_type>(0) };
+        else
+        {
+            value_type slope = value;
+            value = value * x + coefficients[size-2];
+            for (std::size_t i = size-2; i-- > 0;)
+            {
+                slope = slope * x + value;
+                value = value * x + coefficients[i];
             }
+            return { value, slope };
         }
+    }
+}
 
-        // first row
-        for (std::size_t j = 1; j < size; j++) {
-            const computation_type left = U_inv[0][j - 1];
-            U_inv[0][j] = -left * samples_x[j - 1];
+/// \brief Polynomial evaluation strategies
+/// Every policy accepts scalars and simd packs and is usable at compile time.
+/// a*b + c chains are written so compilers contract them into FMA where available.
+namespace polynomial_evaluation
+{
+    /// \brief sum of c[i] * x^i, each power computed separately
+    /// O(n^2) multiplications, kept as reference
+    struct power_sum
+    {
+        template<typename type, std::size_t size, typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static value_type evaluate(const std::array<type, size>& coefficients, const value_type& x)
+        {
+            return polynomial_detail::evaluate_polynomial<type, size, size-1>::value(coefficients, x);
         }
+    };
 
-        // above diagonal, from second row
-        for (std::size_t i = 1; i < size - 1; i++) {
-            for (std::size_t j = i + 1; j < size; j++) {
-                const computation_type up_left = U_inv[i - 1][j - 1];
-                const computation_type left = U_inv[i][j - 1];
-                U_inv[i][j] = up_left - left * samples_x[j - 1];
-            }
+    /// \brief c0 + x*(c1 + x*(c2 + ...))
+    /// fewest operations, one dependency chain of n-1 FMAs; best throughput
+    struct horner
+    {
+        template<typename type, std::size_t size, typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static value_type evaluate(const std::array<type, size>& coefficients, const value_type& x)
+        {
+            value_type result = simd::broadcast<value_type>(coefficients[size-1]);
+            for (std::size_t i = size-1; i-- > 0;)
+                result = result * x + coefficients[i];
+            return result;
         }
+    };
 
-        return U_inv;
-    }
+    /// \brief Estrin's scheme: pairs (c0 + c1*x), (c2 + c3*x), ... combined with x^2, x^4, ...
+    /// dependency chain is O(log n) long, best latency for high degrees
+    struct estrin
+    {
+        template<typename type, std::size_t size, typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static value_type evaluate(const std::array<type, size>& coefficients, const value_type& x)
+        {
+            constexpr std::size_t levels = size > 1 ? std::bit_width(size - 1) : 1;
+            std::array<value_type, levels> powers{};
+            powers[0] = x;
+            for (std::size_t i = 1; i < levels; ++i)
+                powers[i] = powers[i-1] * powers[i-1];
+            return polynomial_detail::evaluate_estrin<0, size>(coefficients, powers);
+        }
+    };
 
-    constexpr static matrix create_Vandermonde_L_inv(const vector &samples_x) {
-        matrix L_inv;
+    /// \brief even(x^2) + x*odd(x^2), both halves by Horner
+    /// two independent chains of half length
+    struct even_odd
+    {
+        template<typename type, std::size_t size, typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static value_type evaluate(const std::array<type, size>& coefficients, const value_type& x)
+        {
+            constexpr std::size_t last_even = (size - 1) / 2 * 2;
+            const value_type x2 = x * x;
+
+            value_type even = simd::broadcast<value_type>(coefficients[last_even]);
+            for (std::size_t i = last_even; i >= 2; i -= 2)
+                even = even * x2 + coefficients[i-2];
+            if constexpr (size < 2)
+                return even;
+            else
+            {
+                constexpr std::size_t last_odd = size / 2 * 2 - 1;
+                value_type odd = simd::broadcast<value_type>(coefficients[last_odd]);
+                for (std::size_t i = last_odd; i >= 3; i -= 2)
+                    odd = odd * x2 + coefficients[i-2];
+                return odd * x + even;
+            }
+        }
+    };
+}
 
-        L_inv[0][0] = static_cast<computation_type>(1);
+/// \brief Interpolation node placement over [min, max]
+namespace polynomial_nodes
+{
+    /// \brief equally spaced nodes, ends included
+    /// largest error is near the ends of range (Runge's phenomenon)
+    struct equispaced
+    {
+        /// \brief fills nodes.size() nodes, size known at run time
+        template<typename type>
+        constexpr static void create(std::span<type> nodes, type min, type max)
+        {
+            const std::size_t size = nodes.size();
+            if (size == 1)
+                nodes[0] = (min + max) / 2;
+            else
+                for (std::size_t i = 0; i < size; ++i)
+                    nodes[i] = min + (max - min) * static_cast<type>(i) / static_cast<type>(size - 1);
+        }
 
-        // above diagonal
-        for (std::size_t i = 0; i < size - 1; i++)
-            for (std::size_t j = i + 1; j < size; j++)
-                L_inv[i][j] = static_cast<computation_type>(0);
+        template<typename type, std::size_t size>
+        constexpr static std::array<type, size> create(type min, type max)
+        {
+            std::array<type, size> nodes{};
+            create(std::span<type>(nodes), min, max);
+            return nodes;
+        }
+    };
 
-        // diagonal
-        for (std::size_t ij = 1; ij < size; ij++) {
-            computation_type product = 1.0f;
-            for (std::size_t k = 0; k < ij; k++) {
-                product *= static_cast<computation_type>(1) /
-                            (samples_x[ij] - samples_x[k]);
+    /// \brief Chebyshev nodes of the first kind, in ascending order
+    /// denser near ends of range, interpolation error is spread almost evenly
+    struct chebyshev
+    {
+        /// \brief fills nodes.size() nodes, size known at run time
+        template<typename type>
+        constexpr static void create(std::span<type> nodes, type min, type max)
+        {
+            const std::size_t size = nodes.size();
+            const type middle = (min + max) / 2;
+            const type half_range = (max - min) / 2;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                const type angle = static_cast<type>(M_PI) * static_cast<type>(2*i + 1) / static_cast<type>(2*size);
+                nodes[i] = middle - half_range * _math_helper::cos(angle);
             }
-            L_inv[ij][ij] = product;
         }
 
-        // below diagonal
-        for (std::size_t i = 1; i < size; i++) {
-            for (std::size_t j = 0; j < i; j++) {
-                L_inv[i][j] = L_inv[i - 1][j] * (static_cast<computation_type>(1) / 
-                            (samples_x[j] - samples_x[i]));
-            }
+        template<typename type, std::size_t size>
+        constexpr static std::array<type, size> create(type min, type max)
+        {
+            std::array<type, size> nodes{};
+            create(std::span<type>(nodes), min, max);
+            return nodes;
         }
-        return L_inv;
+    };
+
+    /// \brief marker for approximate: nodes are equioscillation points found by Remez exchange
+    /// (polynomial::fit_minimax), so there is no create
+    struct minimax {};
+}
+
+/// \brief Fitting helpers usable at compile time and at run time
+namespace polynomial_fit
+{
+    /// \brief Bjorck-Pereyra solution of Vandermonde system sum_j c[j] * nodes[i]^j = values[i]
+    /// works in place, values become coefficients c0, c1, ...; O(n^2) operations and no extra memory.
+    /// Nodes must be distinct; ascending order (as node policies create them) keeps rounding error low
+    template<typename type>
+    constexpr void solve_vandermonde(std::span<const type> nodes, std::span<type> values)
+    {
+        const std::size_t size = nodes.size();
+
+        // Newton divided differences
+        for (std::size_t k = 0; k + 1 < size; ++k)
+            for (std::size_t i = size - 1; i > k; --i)
+                values[i] = (values[i] - values[i-1]) / (nodes[i] - nodes[i-k-1]);
+
+        // Newton form to monomial coefficients
+        for (std::size_t k = size - 1; k-- > 0;)
+            for (std::size_t i = k; i + 1 < size; ++i)
+                values[i] -= nodes[k] * values[i+1];
     }
 
-    constexpr static vector mul(const matrix &m, const vector &v) {
-        vector r;
+    /// \brief interpolates function in coefficients.size() nodes placed over [min, max] by 'node_policy'
+    /// coefficient count is a run time value, so tables can be sized dynamically
+    /// \param function: callable, type(type)
+    template<typename node_policy = polynomial_nodes::chebyshev, typename type, typename function_type>
+    constexpr void interpolate(const function_type& function, type min, type max, std::span<type> coefficients)
+    {
+        std::vector<type> nodes(coefficients.size());
+        node_policy::create(std::span<type>(nodes), min, max);
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+            coefficients[i] = static_cast<type>(function(nodes[i]));
+        solve_vandermonde(std::span<const type>(nodes), coefficients);
+    }
+}
 
-        for (std::size_t i = 0; i < r.size(); i++) {
-            r[i] = static_cast<computation_type>(0);
+namespace polynomial_fit_detail
+{
+    /// fitting is done in extended precision, coefficients are rounded afterwards
+    using fit_type = long double;
+
+    template<std::size_t size, typename precision = fit_type>
+    using vector = std::array<precision, size>;
 
-            for (int k = 0; k < r.size(); k++) {
-                r[i] += m[i][k] * v[k];
+    template<std::size_t size, typename precision = fit_type>
+    using matrix = std::array<vector<size, precision>, size>;
+
+    template<typename precision>
+    constexpr precision abs(const precision& x)
+    {
+        return x < 0 ? -x : x;
+    }
+
+    /// \brief function value in x, functions not taking 'precision' (e.g. double_double)
+    /// are evaluated in fit_type
+    template<typename precision, typename function_type>
+    constexpr precision reference_value(const function_type& function, const precision& x)
+    {
+        if constexpr (std::is_invocable_v<const function_type&, const precision&>)
+            return static_cast<precision>(function(x));
+        else
+            return static_cast<precision>(function(static_cast<fit_type>(x)));
+    }
+
+    /// \brief solves a*x = b, gaussian elimination with partial pivoting
+    template<std::size_t size, typename precision>
+    constexpr vector<size, precision> solve(matrix<size, precision> a, vector<size, precision> b)
+    {
+        for (std::size_t column = 0; column < size; ++column)
+        {
+            std::size_t pivot = column;
+            for (std::size_t row = column + 1; row < size; ++row)
+                if (abs(a[row][column]) > abs(a[pivot][column]))
+                    pivot = row;
+            std::swap(a[column], a[pivot]);
+            std::swap(b[column], b[pivot]);
+
+            for (std::size_t row = column + 1; row < size; ++row)
+            {
+                const precision factor = a[row][column] / a[column][column];
+                for (std::size_t k = column; k < size; ++k)
+                    a[row][k] -= factor * a[column][k];
+                b[row] -= factor * b[column];
             }
         }
 
-        return r;
+        vector<size, precision> x{};
+        for (std::size_t row = size; row-- > 0;)
+        {
+            precision sum = b[row];
+            for (std::size_t k = row + 1; k < size; ++k)
+                sum -= a[row][k] * x[k];
+            x[row] = sum / a[row][row];
+        }
+        return x;
     }
-};
 
-namespace polynomial_detail
-{
-    template<typename computation_type, std::size_t size, std::size_t idx>
-    struct evaluate_polynomial
+    /// \brief Remez exchange algorithm
+    /// returns coefficients of polynomial with 'size' coefficients minimizing
+    /// max |p(x) - function(x)| over [min, max]. Extrema of error are searched on
+    /// a uniform grid, iteration stops once error is levelled within 'tolerance'.
+    /// Linear algebra and error search run in 'precision' (long double or double_double)
+    template<std::size_t size, typename precision = fit_type, typename function_type>
+    constexpr vector<size, precision> remez(const function_type& function, precision min, precision max)
     {
-        constexpr static computation_type value(const typename polynomial_helper<computation_type, size>::vector& coefficients, computation_type param)
+        constexpr std::size_t reference_count = size + 1;
+        constexpr std::size_t sample_count = 32 * size + 1;
+        constexpr std::size_t max_iterations = 16;
+        constexpr fit_type tolerance = 1e-4l;
+
+        // initial reference: extrema of Chebyshev polynomial of degree 'size'
+        vector<reference_count, precision> reference{};
+        const precision middle = (min + max) / 2;
+        const precision half_range = (max - min) / 2;
+        for (std::size_t i = 0; i < reference_count; ++i)
+            reference[i] = middle - half_range * precision(_math_helper::cos(static_cast<fit_type>(M_PI) * i / size));
+
+        // search grid is the same every iteration, so function is evaluated on it once
+        const fit_type search_min = static_cast<fit_type>(min);
+        const fit_type search_max = static_cast<fit_type>(max);
+        std::array<fit_type, sample_count> sample_x{};
+        std::array<fit_type, sample_count> sample_value{};
+        for (std::size_t k = 0; k < sample_count; ++k)
         {
-            return evaluate_polynomial<computation_type, size, idx-1>::value(coefficients, param) 
-                + _math_helper::pow<computation_type, idx>(param) * coefficients[idx];
+            sample_x[k] = search_min + (search_max - search_min) * k / (sample_count - 1);
+            sample_value[k] = reference_value(function, sample_x[k]);
         }
-    };
 
-    template<typename computation_type, std::size_t size>
-    struct evaluate_polynomial<computation_type, size, 0>
-    {
-        constexpr static computation_type value(const typename polynomial_helper<computation_type, size>::vector& coefficients, computation_type param)
+        // once error reaches rounding noise of precision exchange stops improving,
+        // so best iterate is kept rather than last one
+        vector<size, precision> coefficients{};
+        vector<size, precision> best_coefficients{};
+        fit_type best_error = -1;
+        for (std::size_t iteration = 0; iteration < max_iterations; ++iteration)
         {
-            return coefficients[0];
+            // p(x_i) + (-1)^i * E = f(x_i)
+            matrix<reference_count, precision> system{};
+            vector<reference_count, precision> values{};
+            for (std::size_t i = 0; i < reference_count; ++i)
+            {
+                precision power = 1;
+                for (std::size_t j = 0; j < size; ++j)
+                {
+                    system[i][j] = power;
+                    power *= reference[i];
+                }
+                system[i][size] = i % 2 == 0 ? 1 : -1;
+                values[i] = reference_value(function, reference[i]);
+            }
+            const vector<reference_count, precision> solution = solve(system, values);
+            vector<size> search_coefficients{};
+            for (std::size_t j = 0; j < size; ++j)
+            {
+                coefficients[j] = solution[j];
+                search_coefficients[j] = static_cast<fit_type>(solution[j]);
+            }
+            const fit_type levelled_error = abs(static_cast<fit_type>(solution[size]));
+
+            // extremum of every run of same error sign; only the solve is ill-conditioned,
+            // so search runs in fit_type, which keeps double_double fits within constexpr limits
+            std::array<fit_type, sample_count> extremum_x{};
+            std::array<fit_type, sample_count> extremum_error{};
+            std::size_t run_count = 0;
+            fit_type max_error = 0;
+            for (std::size_t k = 0; k < sample_count; ++k)
+            {
+                const fit_type x = sample_x[k];
+                fit_type p = search_coefficients[size-1];
+                for (std::size_t j = size-1; j-- > 0;)
+                    p = p * x + search_coefficients[j];
+                const fit_type error = p - sample_value[k];
+                max_error = abs(error) > max_error ? abs(error) : max_error;
+
+                const bool same_run = run_count > 0 && (error < 0) == (extremum_error[run_count-1] < 0);
+                if (!same_run)
+                {
+                    extremum_x[run_count] = x;
+                    extremum_error[run_count] = error;
+                    ++run_count;
+                }
+                else if (abs(error) > abs(extremum_error[run_count-1]))
+                {
+                    extremum_x[run_count-1] = x;
+                    extremum_error[run_count-1] = error;
+                }
+            }
+
+            if (best_error < 0 || max_error < best_error)
+            {
+                best_coefficients = coefficients;
+                best_error = max_error;
+            }
+            if (max_error - levelled_error <= tolerance * max_error || run_count < reference_count)
+                break;
+
+            // keep 'reference_count' consecutive runs, dropping smaller end first keeps global maximum
+            std::size_t first = 0;
+            std::size_t last = run_count - 1;
+            while (last - first + 1 > reference_count)
+            {
+                if (abs(extremum_error[first]) < abs(extremum_error[last]))
+                    ++first;
+                else
+                    --last;
+            }
+            for (std::size_t i = 0; i < reference_count; ++i)
+                reference[i] = static_cast<precision>(extremum_x[first + i]);
         }
-    };
+        return best_coefficients;
+    }
 }
 
 /// \brief Polynomial template class
 /// coefficients and evaluation precision are set by template parameter 'type'
-template<typename type, std::size_t size>
+/// evaluation order is set by 'evaluation_policy', see polynomial_evaluation
+template<typename type, std::size_t size, typename evaluation_policy = polynomial_evaluation::horner>
 class polynomial {
 public:
     template <typename table_type>
@@ -161,7 +479,15 @@ public:
     /// \brief calculates polynomial value in given x
     ///
     constexpr type evaluate(type x) const {
-        return polynomial_detail::evaluate_polynomial<type, size, size-1>::value(mCoefficients, x);
+        return evaluation_policy::evaluate(mCoefficients, x);
+    }
+
+    /// \brief calculates polynomial values in every lane of simd pack x
+    ///
+    template<typename value_type>
+        requires (!std::is_arithmetic_v<value_type>)
+    TRIGONOMETRY_FORCE_INLINE constexpr value_type evaluate(const value_type& x) const {
+        return evaluation_policy::evaluate(mCoefficients, x);
     }
 
     /// \brief calculates polynomial value in given x
@@ -171,32 +497,184 @@ public:
         return evaluate(x);
     }
 
+    template<typename value_type>
+        requires (!std::is_arithmetic_v<value_type>)
+    TRIGONOMETRY_FORCE_INLINE constexpr value_type operator() (const value_type& x) const
+    {
+        return evaluate(x);
+    }
+
+    /// \brief p(x) and p'(x) from one Horner pass, first is value, second is slope
+    /// same multiply-add count as separate p and p' evaluations, but both chains run side by side,
+    /// so latency is that of p alone; evaluation_policy is not used
+    constexpr std::pair<type, type> evaluate_with_derivative(type x) const {
+        return polynomial_detail::evaluate_with_derivative(mCoefficients, x);
+    }
+
+    template<typename value_type>
+        requires (!std::is_arithmetic_v<value_type>)
+    TRIGONOMETRY_FORCE_INLINE constexpr std::pair<value_type, value_type> evaluate_with_derivative(const value_type& x) const {
+        return polynomial_detail::evaluate_with_derivative(mCoefficients, x);
+    }
+
+    /// \brief p', one coefficient less (zero constant for size 1)
+    constexpr auto derivative() const {
+        constexpr std::size_t derivative_size = size > 1 ? size - 1 : 1;
+        std::array<type, derivative_size> coefficients{};
+        for (std::size_t i = 1; i < size; ++i)
+            coefficients[i - 1] = mCoefficients[i] * static_cast<type>(i);
+        return polynomial<type, derivative_size, evaluation_policy>(coefficients);
+    }
+
+    /// \brief integral of p with zero free coefficient, one coefficient more
+    constexpr polynomial<type, size + 1, evaluation_policy> antiderivative() const {
+        std::array<type, size + 1> coefficients{};
+        for (std::size_t i = 0; i < size; ++i)
+            coefficients[i + 1] = mCoefficients[i] / static_cast<type>(i + 1);
+        return polynomial<type, size + 1, evaluation_policy>(coefficients);
+    }
+
     /// \brief Interpolates table function
+    /// coefficients are solved in place by polynomial_fit::solve_vandermonde, O(size) memory
     /// \param points: map of function parameters and values
-    constexpr static polynomial<type, size> interpolate(const table_type& sample_table) {
+    constexpr static polynomial interpolate(const table_type& sample_table) {
         static_assert(size > 0, "cannot interpolate using empty table");
-        constexpr std::size_t sample_count = size;
-        constexpr std::size_t coefficient_count = size;
-        constexpr std::size_t polynomial_power = size - 1;
-
-        typename polynomial_helper<type, sample_count>::vector X;
-        typename polynomial_helper<type, sample_count>::vector Y;
 
-        std::size_t indx = 0;
-        for (const auto [param, value] : sample_table) {
-            X[indx] = param;
-            Y[indx] = value;
-            indx++;
+        coefficient_list_type X{};
+        coefficient_list_type C{};
+        for (std::size_t i = 0; i < size; ++i) {
+            X[i] = sample_table[i].first;
+            C[i] = sample_table[i].second;
         }
 
-        const auto L_inv = polynomial_helper<type, size>::create_Vandermonde_L_inv(X);
+        polynomial_fit::solve_vandermonde(std::span<const type>(X), std::span<type>(C));
+        return polynomial(C);
+    }
+
+    /// \brief Interpolates function in nodes placed over [min, max] by 'node_policy'
+    /// \param function: callable, type(type)
+    template<typename node_policy = polynomial_nodes::chebyshev, typename function_type>
+    constexpr static polynomial interpolate(const function_type& function, type min, type max) {
+        const auto nodes = node_policy::template create<type, size>(min, max);
 
-        const auto U_inv = polynomial_helper<type, size>::create_Vandermonde_U_inv(X);
+        table_type sample_table;
+        for (std::size_t i = 0; i < size; ++i)
+            sample_table[i] = std::make_pair(nodes[i], static_cast<type>(function(nodes[i])));
 
-        const auto C = polynomial_helper<type, size>::mul(
-            U_inv, 
-            polynomial_helper<type, size>::mul(L_inv, Y));
+        return interpolate(sample_table);
+    }
 
-        return polynomial<type, size>(C);
+    /// \brief Best uniform (minimax) approximation of function over [min, max]
+    /// computed by Remez exchange in 'fit_precision': long double by default,
+    /// double_double for high degree double tables whose solve loses long double digits
+    /// \param function: callable, long double(long double) or fit_precision(fit_precision)
+    template<typename fit_precision = polynomial_fit_detail::fit_type, typename function_type>
+    constexpr static polynomial fit_minimax(const function_type& function, type min, type max) {
+        const auto fitted = polynomial_fit_detail::remez<size, fit_precision>(function,
+            static_cast<fit_precision>(min),
+            static_cast<fit_precision>(max));
+
+        coefficient_list_type coefficients{};
+        for (std::size_t i = 0; i < size; ++i)
+            coefficients[i] = static_cast<type>(fitted[i]);
+        return polynomial(coefficients);
     }
 };
+
+/// \brief Polynomial algebra
+/// results are polynomial types sized for exact result and usable in constant expressions,
+/// so fused kernels are built from fitted tables at compile time; result takes evaluation_policy
+/// of left (outer) operand
+template<typename type, std::size_t left_size, std::size_t right_size, typename evaluation_policy, typename right_policy>
+constexpr polynomial<type, (left_size > right_size ? left_size : right_size), evaluation_policy> operator+(
+    const polynomial<type, left_size, evaluation_policy>& left, const polynomial<type, right_size, right_policy>& right)
+{
+    std::array<type, (left_size > right_size ? left_size : right_size)> coefficients{};
+    for (std::size_t i = 0; i < left_size; ++i)
+        coefficients[i] += left.getCoefficients()[i];
+    for (std::size_t i = 0; i < right_size; ++i)
+        coefficients[i] += right.getCoefficients()[i];
+    return coefficients;
+}
+
+template<typename type, std::size_t left_size, std::size_t right_size, typename evaluation_policy, typename right_policy>
+constexpr polynomial<type, (left_size > right_size ? left_size : right_size), evaluation_policy> operator-(
+    const polynomial<type, left_size, evaluation_policy>& left, const polynomial<type, right_size, right_policy>& right)
+{
+    std::array<type, (left_size > right_size ? left_size : right_size)> coefficients{};
+    for (std::size_t i = 0; i < left_size; ++i)
+        coefficients[i] += left.getCoefficients()[i];
+    for (std::size_t i = 0; i < right_size; ++i)
+        coefficients[i] -= right.getCoefficients()[i];
+    return coefficients;
+}
+
+template<typename type, std::size_t left_size, std::size_t right_size, typename evaluation_policy, typename right_policy>
+constexpr polynomial<type, left_size + right_size - 1, evaluation_policy> operator*(
+    const polynomial<type, left_size, evaluation_policy>& left, const polynomial<type, right_size, right_policy>& right)
+{
+    std::array<type, left_size + right_size - 1> coefficients{};
+    for (std::size_t i = 0; i < left_size; ++i)
+        for (std::size_t j = 0; j < right_size; ++j)
+            coefficients[i + j] += left.getCoefficients()[i] * right.getCoefficients()[j];
+    return coefficients;
+}
+
+/// \brief outer(inner(x)), Horner scheme on polynomials: every step multiplies by inner
+/// and adds next outer coefficient
+template<typename type, std::size_t outer_size, std::size_t inner_size, typename evaluation_policy, typename inner_policy>
+constexpr polynomial<type, (outer_size - 1) * (inner_size - 1) + 1, evaluation_policy> compose(
+    const polynomial<type, outer_size, evaluation_policy>& outer, const polynomial<type, inner_size, inner_policy>& inner)
+{
+    constexpr std::size_t result_size = (outer_size - 1) * (inner_size - 1) + 1;
+    std::array<type, result_size> coefficients{};
+    coefficients[0] = outer.getCoefficients()[outer_size - 1];
+    std::size_t result_degree = 0;
+    for (std::size_t i = outer_size - 1; i-- > 0;)
+    {
+        std::array<type, result_size> product{};
+        for (std::size_t a = 0; a <= result_degree; ++a)
+            for (std::size_t b = 0; b < inner_size; ++b)
+                product[a + b] += coefficients[a] * inner.getCoefficients()[b];
+        product[0] += outer.getCoefficients()[i];
+        result_degree += inner_size - 1;
+        coefficients = product;
+    }
+    return coefficients;
+}
+
+/// \brief Fitting quality helpers
+namespace polynomial_fit
+{
+    /// \brief max |p(x) - function(x)| sampled on 'sample_count' uniform points of [min, max]
+    /// p is evaluated in its own precision, function in extended precision
+    template<std::size_t sample_count = 1024, typename type, std::size_t size, typename evaluation_policy, typename function_type>
+    constexpr polynomial_fit_detail::fit_type max_error(const polynomial<type, size, evaluation_policy>& p, const function_type& function, type min, type max)
+    {
+        using fit_type = polynomial_fit_detail::fit_type;
+        fit_type result = 0;
+        for (std::size_t k = 0; k < sample_count; ++k)
+        {
+            const type x = min + (max - min) * static_cast<type>(k) / static_cast<type>(sample_count - 1);
+            const fit_type error = polynomial_fit_detail::abs(static_cast<fit_type>(p(x)) - function(static_cast<fit_type>(x)));
+            result = error > result ? error : result;
+        }
+        return result;
+    }
+
+    /// \brief smallest polynomial size in [1, max_size] whose minimax fit of function
+    /// over [min, max] stays within 'allowed_error', 0 if none does
+    template<typename type, std::size_t max_size, std::size_t size = 1, typename function_type>
+    constexpr std::size_t minimal_size(const function_type& function, type min, type max, polynomial_fit_detail::fit_type allowed_error)
+    {
+        if constexpr (size > max_size)
+            return 0;
+        else
+        {
+            const auto fitted = polynomial<type, size>::fit_minimax(function, min, max);
+            if (max_error(fitted, function, min, max) <= allowed_error)
+                return size;
+            return minimal_size<type, max_size, size + 1>(function, min, max, allowed_error);
+        }
+    }
+}
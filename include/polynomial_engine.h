@@ -0,0 +1,406 @@
+#pragma once
+
+#include "coefficient_table.h"
+#include "polynomial.h"
+#include "range_reduction.h"
+#include "simd.h"
+#include "trigonometry.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+/// \brief functions provided by polynomial_engine
+enum class engine_function
+{
+    sin,
+    cos,
+    tan,
+    asin,
+    acos,
+    atan
+};
+
+namespace _engine_detail
+{
+    constexpr std::size_t min_size = 2;
+    constexpr std::size_t max_size = 12;
+
+    /// polynomials cached by engine, sin, cos and tan share both octant polynomials
+    using kernel_polynomial = coefficient_table::kernel;
+
+    constexpr std::size_t kernel_polynomial_count = coefficient_table::kernel_count;
+
+    template<typename type>
+    using evaluate_function = type (*)(const type* coefficients, type x);
+
+    template<typename type>
+    using fit_function = void (*)(kernel_polynomial polynomial_id, type* coefficients);
+
+    /// \brief result[i] = function(x[i]) from primary and secondary coefficients
+    template<typename type>
+    using evaluate_array_function = void (*)(engine_function function, const type* primary, const type* secondary,
+        const type* x, type* result, std::size_t count);
+
+    /// \brief Horner's scheme on type or pack of type, trip count is known so loop is unrolled
+    template<typename type, std::size_t size, typename value_type>
+    TRIGONOMETRY_FORCE_INLINE value_type horner(const type* coefficients, const value_type& x)
+    {
+        value_type result = simd::broadcast<value_type>(coefficients[size-1]);
+        for (std::size_t i = size-1; i-- > 0;)
+            result = result * x + coefficients[i];
+        return result;
+    }
+
+    template<typename type, std::size_t size>
+    type evaluate(const type* coefficients, type x)
+    {
+        return horner<type, size>(coefficients, x);
+    }
+
+    /// \brief sin, cos and tan from sin and cos octant polynomials, kernel of simd::transform
+    template<typename type, std::size_t size, engine_function function>
+    struct octant_kernel
+    {
+        const type* sin_coefficients;
+        const type* cos_coefficients;
+
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE value_type apply(const value_type& x) const
+        {
+            value_type r{};
+            value_type quadrant{};
+            _math_detail::reduce_quadrant<type>(x, r, quadrant);
+            const value_type r2 = r * r;
+            value_type sin{};
+            value_type cos{};
+            _math_detail::sincos_from_octant<type>(quadrant, r * horner<type, size>(sin_coefficients, r2),
+                horner<type, size>(cos_coefficients, r2), sin, cos);
+            if constexpr (function == engine_function::sin)
+                return sin;
+            else if constexpr (function == engine_function::cos)
+                return cos;
+            else
+                return sin / cos;
+        }
+    };
+
+    /// \brief asin and acos, NaN outside [-1, 1] as asin and acos of trigonometry
+    template<typename type, std::size_t size, engine_function function>
+    struct asin_kernel
+    {
+        const type* coefficients;
+
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE value_type apply(const value_type& x) const
+        {
+            constexpr type pi_two = M_PI_2;
+            const value_type polynomial = horner<type, size>(coefficients, x);
+            const value_type nan = simd::broadcast<value_type>(std::numeric_limits<type>::quiet_NaN());
+            const value_type asin = simd::select(simd::abs(x) <= 1, polynomial, nan);
+            if constexpr (function == engine_function::asin)
+                return asin;
+            else
+                return pi_two - asin;
+        }
+    };
+
+    template<typename type, std::size_t size>
+    struct atan_kernel
+    {
+        const type* coefficients;
+
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE value_type apply(const value_type& x) const
+        {
+            const value_type z = _math_detail::atan_reduce(x);
+            return _math_detail::atan_from_octant<type>(x, z * horner<type, size>(coefficients, z * z));
+        }
+    };
+
+    /// \brief batch kernels are dispatched by simd::transform as batch versions of trigonometry
+    template<typename type, std::size_t size>
+    void evaluate_array(engine_function function, const type* primary, const type* secondary, const type* x, type* result, std::size_t count)
+    {
+        switch (function)
+        {
+        case engine_function::sin:
+            simd::transform(octant_kernel<type, size, engine_function::sin>{primary, secondary}, count, result, x);
+            break;
+        case engine_function::cos:
+            simd::transform(octant_kernel<type, size, engine_function::cos>{primary, secondary}, count, result, x);
+            break;
+        case engine_function::tan:
+            simd::transform(octant_kernel<type, size, engine_function::tan>{primary, secondary}, count, result, x);
+            break;
+        case engine_function::asin:
+            simd::transform(asin_kernel<type, size, engine_function::asin>{primary}, count, result, x);
+            break;
+        case engine_function::acos:
+            simd::transform(asin_kernel<type, size, engine_function::acos>{primary}, count, result, x);
+            break;
+        default:
+            simd::transform(atan_kernel<type, size>{primary}, count, result, x);
+            break;
+        }
+    }
+
+    /// \brief coefficients of kernel polynomial with 'size' coefficients, same as trigonometry<type, size>
+    /// and table_generator use: generated table if there is one, minimax fit otherwise
+    template<typename type, std::size_t size>
+    void fit(kernel_polynomial polynomial_id, type* coefficients)
+    {
+        const auto create = [polynomial_id]
+        {
+            switch (polynomial_id)
+            {
+            case kernel_polynomial::sin_octant: return _math_detail::create_sin_polynomial<type, size>();
+            case kernel_polynomial::cos_octant: return _math_detail::create_cos_polynomial<type, size>();
+            case kernel_polynomial::asin: return _math_detail::create_asin_polynomial<type, size>();
+            default: return _math_detail::create_atan_polynomial<type, size>();
+            }
+        };
+        const auto fitted = create().getCoefficients();
+        std::copy(fitted.begin(), fitted.end(), coefficients);
+    }
+
+    /// \brief per size kernels, only these are instantiated for every size
+    template<typename type>
+    struct size_kernels
+    {
+        evaluate_function<type> evaluate;
+        evaluate_array_function<type> evaluate_array;
+        fit_function<type> fit;
+    };
+
+    template<typename type, std::size_t... offsets>
+    constexpr std::array<size_kernels<type>, sizeof...(offsets)> create_size_kernel_table(std::index_sequence<offsets...>)
+    {
+        return {size_kernels<type>{
+            &evaluate<type, min_size + offsets>,
+            &evaluate_array<type, min_size + offsets>,
+            &fit<type, min_size + offsets>}...};
+    }
+
+    /// size_kernel_table<type>[size - min_size]
+    template<typename type>
+    inline constexpr auto size_kernel_table = create_size_kernel_table<type>(std::make_index_sequence<max_size - min_size + 1>());
+
+    /// \brief polynomial with coefficients owned by engine and kernel selected by size
+    template<typename type>
+    struct runtime_polynomial
+    {
+        const type* coefficients;
+        evaluate_function<type> evaluate;
+
+        type operator()(type x) const
+        {
+            return evaluate(coefficients, x);
+        }
+    };
+}
+
+/// \brief Polynomial approximations whose size is chosen at run time
+/// Coefficients are fitted on first use of (function, size) and cached in cache line
+/// aligned buffers owned by engine, or adopted from a generated binary table (load); type is fixed per engine. Cache lookup is one atomic load,
+/// only building takes a lock, so engine is shared by threads freely.
+/// Fits are minimax as in trigonometry, so (function, size) has same coefficients as trigonometry<type, size>
+/// whether fitted or loaded; fitting and unrolled Horner kernels are instantiated per size and reached through a function pointer table; batch kernels are
+/// dispatched to simd instruction sets as in trigonometry, argument reduction is the same as there.
+template<typename type>
+class polynomial_engine {
+public:
+    constexpr static std::size_t min_size = _engine_detail::min_size;
+    constexpr static std::size_t max_size = _engine_detail::max_size;
+
+    /// \brief one function at one size, cheap to copy, valid as long as its engine
+    /// approximation of size outside [min_size, max_size] is invalid, its results are NaN
+    class approximation {
+    public:
+        /// \brief calculates function value in given x
+        type operator() (type x) const
+        {
+            if (!valid()) [[unlikely]]
+                return std::numeric_limits<type>::quiet_NaN();
+            switch (mFunction)
+            {
+            case engine_function::sin:
+            case engine_function::cos:
+            case engine_function::tan:
+                {
+                    type sin{};
+                    type cos{};
+                    sincos(x, sin, cos);
+                    return mFunction == engine_function::sin ? sin : (mFunction == engine_function::cos ? cos : sin / cos);
+                }
+            case engine_function::asin:
+            case engine_function::acos:
+                {
+                    // outside [-1, 1] NaN, not polynomial extrapolation
+                    const type asin = std::fabs(x) <= 1 ? mPrimary(x) : std::numeric_limits<type>::quiet_NaN();
+                    return mFunction == engine_function::asin ? asin : static_cast<type>(M_PI_2) - asin;
+                }
+            default:
+                {
+                    const type z = _math_detail::atan_reduce(x);
+                    return _math_detail::atan_from_octant<type>(x, z * mPrimary(z * z));
+                }
+            }
+        }
+
+        /// \brief batch version, result[i] = f(x[i]); result must be at least as long as x, may alias x
+        void operator() (std::span<const type> x, std::span<type> result) const
+        {
+            assert(result.size() >= x.size());
+            if (!valid()) [[unlikely]]
+            {
+                std::fill(result.begin(), result.begin() + x.size(), std::numeric_limits<type>::quiet_NaN());
+                return;
+            }
+            mEvaluateArray(mFunction, mPrimary.coefficients, mSecondary.coefficients, x.data(), result.data(), x.size());
+        }
+
+        engine_function function() const { return mFunction; }
+        std::size_t size() const { return mSize; }
+        /// \brief false if size requested from get was outside [min_size, max_size]
+        bool valid() const { return mEvaluateArray != nullptr; }
+
+    private:
+        friend class polynomial_engine;
+
+        using runtime_polynomial = _engine_detail::runtime_polynomial<type>;
+
+        approximation(engine_function function, std::size_t size, runtime_polynomial primary, runtime_polynomial secondary,
+            _engine_detail::evaluate_array_function<type> evaluate_array) :
+            mFunction(function),
+            mSize(size),
+            mPrimary(primary),
+            mSecondary(secondary),
+            mEvaluateArray(evaluate_array)
+        {
+        }
+
+        /// primary is sin octant polynomial, secondary cos octant polynomial
+        void sincos(type x, type& sin, type& cos) const
+        {
+            type r{};
+            type quadrant{};
+            _math_detail::reduce_quadrant<type>(x, r, quadrant);
+            const type r2 = r * r;
+            _math_detail::sincos_from_octant<type>(quadrant, r * mPrimary(r2), mSecondary(r2), sin, cos);
+        }
+
+        engine_function mFunction;
+        std::size_t mSize;
+        runtime_polynomial mPrimary;
+        runtime_polynomial mSecondary;
+        _engine_detail::evaluate_array_function<type> mEvaluateArray;
+    };
+
+    polynomial_engine() = default;
+    polynomial_engine(const polynomial_engine&) = delete;
+    polynomial_engine& operator=(const polynomial_engine&) = delete;
+
+    /// \brief approximation of function with 'size' coefficients per polynomial
+    /// first call for (function, size) fits coefficients. Size comes from run time input,
+    /// so it is checked in every build: size outside [min_size, max_size] gives an invalid approximation
+    approximation get(engine_function function, std::size_t size)
+    {
+        using _engine_detail::kernel_polynomial;
+        if (size < min_size || size > max_size)
+            return approximation(function, size, {}, {}, nullptr);
+
+        const auto& kernels = _engine_detail::size_kernel_table<type>[size - min_size];
+        const auto create = [&](kernel_polynomial polynomial_id)
+        {
+            return _engine_detail::runtime_polynomial<type>{coefficients(polynomial_id, size), kernels.evaluate};
+        };
+
+        switch (function)
+        {
+        case engine_function::sin:
+        case engine_function::cos:
+        case engine_function::tan:
+            return approximation(function, size, create(kernel_polynomial::sin_octant), create(kernel_polynomial::cos_octant),
+                kernels.evaluate_array);
+        case engine_function::asin:
+        case engine_function::acos:
+            return approximation(function, size, create(kernel_polynomial::asin), create(kernel_polynomial::asin),
+                kernels.evaluate_array);
+        default:
+            return approximation(function, size, create(kernel_polynomial::atan_octant), create(kernel_polynomial::atan_octant),
+                kernels.evaluate_array);
+        }
+    }
+
+    /// \brief takes coefficients of 'type' from binary table, e.g. coefficient_table::mapped_file
+    /// of table_generator output, so their first use fits nothing. Coefficients are used in place,
+    /// table bytes must outlive engine; kernels built before are kept. Returns number of adopted tables
+    std::size_t load(const coefficient_table::view& table)
+    {
+        std::lock_guard<std::mutex> lock(mBuildMutex);
+        std::size_t loaded = 0;
+        for (const coefficient_table::record_header& record : table.records())
+        {
+            if (record.scalar_size != sizeof(type) || record.kernel_id >= _engine_detail::kernel_polynomial_count ||
+                record.size < min_size || record.size > max_size)
+                continue;
+            std::atomic<const type*>& slot = mCache[record.kernel_id * (max_size + 1) + record.size];
+            if (slot.load(std::memory_order_relaxed) != nullptr)
+                continue;
+            slot.store(table.coefficients<type>(record).data(), std::memory_order_release);
+            ++loaded;
+        }
+        return loaded;
+    }
+
+    /// \brief fits every function at every size ahead of time, so later get calls never lock
+    void prepare_all()
+    {
+        for (std::size_t polynomial_id = 0; polynomial_id < _engine_detail::kernel_polynomial_count; ++polynomial_id)
+            for (std::size_t size = min_size; size <= max_size; ++size)
+                coefficients(static_cast<_engine_detail::kernel_polynomial>(polynomial_id), size);
+    }
+
+protected:
+    struct alignas(64) coefficient_buffer
+    {
+        std::array<type, max_size> values{};
+    };
+
+    /// \brief cached coefficients, fitted under lock on first request
+    const type* coefficients(_engine_detail::kernel_polynomial polynomial_id, std::size_t size)
+    {
+        if (static_cast<std::size_t>(polynomial_id) >= _engine_detail::kernel_polynomial_count || size < min_size || size > max_size)
+            return nullptr;
+        std::atomic<const type*>& slot = mCache[static_cast<std::size_t>(polynomial_id) * (max_size + 1) + size];
+        const type* cached = slot.load(std::memory_order_acquire);
+        if (cached != nullptr)
+            return cached;
+
+        std::lock_guard<std::mutex> lock(mBuildMutex);
+        cached = slot.load(std::memory_order_relaxed);
+        if (cached != nullptr)
+            return cached;
+
+        auto buffer = std::make_unique<coefficient_buffer>();
+        _engine_detail::size_kernel_table<type>[size - min_size].fit(polynomial_id, buffer->values.data());
+        cached = buffer->values.data();
+        mBuffers.push_back(std::move(buffer));
+        slot.store(cached, std::memory_order_release);
+        return cached;
+    }
+
+    std::array<std::atomic<const type*>, _engine_detail::kernel_polynomial_count * (max_size + 1)> mCache{};
+    std::mutex mBuildMutex;
+    std::vector<std::unique_ptr<coefficient_buffer>> mBuffers;
+};
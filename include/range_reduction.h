@@ -0,0 +1,266 @@
+#pragma once
+
+#include "simd.h"
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+/// \brief Argument range contracts
+/// trigonometry functions take a range as template parameter; a bounded range promises
+/// min <= x <= max, so kernels leave out reduction steps and input checks the range does not need.
+/// Contracts are asserted in debug builds
+namespace argument_range
+{
+    /// \brief any argument: full reduction and input checks
+    struct unbounded {};
+
+    /// \brief arguments in [min, max]
+    template<double min, double max>
+    struct bounded
+    {
+        static_assert(min <= max, "empty argument range");
+        constexpr static double lower = min;
+        constexpr static double upper = max;
+    };
+
+    /// sin and cos polynomials without any reduction
+    using octant = bounded<-M_PI_4, M_PI_4>;
+    /// one turn around zero: Cody-Waite reduction without huge argument check
+    using half_turn = bounded<-M_PI, M_PI>;
+    /// asin and acos without domain check, atan without reciprocal
+    using unit = bounded<-1.0, 1.0>;
+
+    template<typename range>
+    inline constexpr bool is_bounded = !std::is_same_v<range, unbounded>;
+
+    /// \brief true if range promises arguments in [-bound, bound]
+    template<typename range>
+    constexpr bool within(double bound)
+    {
+        if constexpr (is_bounded<range>)
+            return -bound <= range::lower && range::upper <= bound;
+        else
+            return false;
+    }
+
+    /// \brief true if x keeps contract of range, bounds are rounded to type of x
+    template<typename range, typename type>
+    constexpr bool contains(type x)
+    {
+        if constexpr (is_bounded<range>)
+            return static_cast<type>(range::lower) <= x && x <= static_cast<type>(range::upper);
+        else
+            return true;
+    }
+
+    /// \brief true if every element of x converted to computation_type keeps contract of range
+    template<typename range, typename computation_type, typename storage_type>
+    bool contains_all(std::span<const storage_type> x)
+    {
+        if constexpr (is_bounded<range>)
+        {
+            for (const storage_type& element : x)
+                if (!contains<range>(simd::convert<computation_type>(element)))
+                    return false;
+        }
+        return true;
+    }
+}
+
+namespace _math_detail
+{
+    /// \brief Cody-Waite split of pi/2 into three parts
+    /// k * pi_2_hi and k * pi_2_mid are exact while k stays below 2^quadrant_bits,
+    /// which holds for |x| <= limit
+    template<typename computation_type>
+    struct reduction_constants;
+
+    template<>
+    struct reduction_constants<float>
+    {
+        static constexpr float two_over_pi = 0x1.45f306p-1f;
+        static constexpr float pi_2_hi = 0x1.92p+0f;
+        static constexpr float pi_2_mid = 0x1.fb4p-12f;
+        static constexpr float pi_2_lo = 0x1.4442d2p-24f;
+        static constexpr float limit = 0x1p13f;
+    };
+
+    template<>
+    struct reduction_constants<double>
+    {
+        static constexpr double two_over_pi = 0x1.45f306dc9c883p-1;
+        static constexpr double pi_2_hi = 0x1.921fb544p+0;
+        static constexpr double pi_2_mid = 0x1.0b4611a6p-34;
+        static constexpr double pi_2_lo = 0x1.3198a2e037073p-69;
+        static constexpr double limit = 0x1p20;
+    };
+
+    /// bits of 2/pi after binary point, most significant first;
+    /// enough for largest double exponent
+    inline constexpr std::uint64_t two_over_pi_bits[] = {
+        0xa2f9836e4e441529ull, 0xfc2757d1f534ddc0ull, 0xdb6295993c439041ull, 0xfe5163abdebbc561ull,
+        0xb7246e3a424dd2e0ull, 0x06492eea09d1921cull, 0xfe1deb1cb129a73eull, 0xe88235f52ebb4484ull,
+        0xe99c7026b45f7e41ull, 0x3991d639835339f4ull, 0x9c845f8bbdf9283bull, 0x1ff897ffde05980full,
+        0xef2f118b5a0a6d1full, 0x6d367ecf27cb09b7ull, 0x4f463f669e5fea2dull, 0x7527bac7ebe5f17bull,
+        0x3d0739f78a5292eaull, 0x6bfb5fb11f8d5d08ull, 0x56033046fc7b6babull
+    };
+
+    /// \brief 64 bits of 2/pi starting at bit 'first'
+    /// bit 1 is first bit after binary point, bits before it are zero
+    constexpr std::uint64_t two_over_pi_window(int first)
+    {
+        if (first <= -63)
+            return 0;
+        if (first < 1)
+            return two_over_pi_bits[0] >> (1 - first);
+
+        const int offset = first - 1;
+        const int word = offset / 64;
+        const int shift = offset % 64;
+        return shift == 0
+            ? two_over_pi_bits[word]
+            : (two_over_pi_bits[word] << shift) | (two_over_pi_bits[word + 1] >> (64 - shift));
+    }
+
+    /// \brief unsigned 128 bit integer as two words
+    struct uint128_words
+    {
+        std::uint64_t hi;
+        std::uint64_t lo;
+    };
+
+    /// \brief full product of two 64 bit words, from 32 bit halves where __int128 is missing
+    constexpr uint128_words multiply_wide(std::uint64_t a, std::uint64_t b)
+    {
+#if defined(__SIZEOF_INT128__)
+        const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        return {static_cast<std::uint64_t>(product >> 64), static_cast<std::uint64_t>(product)};
+#else
+        constexpr std::uint64_t low_half = 0xffffffffull;
+        const std::uint64_t lo_lo = (a & low_half) * (b & low_half);
+        const std::uint64_t hi_lo = (a >> 32) * (b & low_half);
+        const std::uint64_t lo_hi = (a & low_half) * (b >> 32);
+        const std::uint64_t hi_hi = (a >> 32) * (b >> 32);
+        // sum of three terms below 2^32 * 2^32 cannot overflow
+        const std::uint64_t middle = (lo_lo >> 32) + (hi_lo & low_half) + lo_hi;
+        return {hi_hi + (hi_lo >> 32) + (middle >> 32), (middle << 32) | (lo_lo & low_half)};
+#endif
+    }
+
+    /// \brief Payne-Hanek reduction of any finite double
+    /// returns r with x = (quadrant + k*4) * pi/2 + r, |r| <= pi/4
+    constexpr double reduce_payne_hanek(double x, int& quadrant)
+    {
+        const std::uint64_t bits = std::bit_cast<std::uint64_t>(x);
+        const int biased_exponent = static_cast<int>((bits >> 52) & 0x7ff);
+        if (biased_exponent == 0x7ff)
+        {
+            quadrant = 0;
+            return x - x;
+        }
+
+        // |x| = mantissa * 2^exponent
+        const std::uint64_t mantissa = (bits & ((1ull << 52) - 1)) | (biased_exponent != 0 ? 1ull << 52 : 0);
+        const int exponent = (biased_exponent != 0 ? biased_exponent : 1) - 1075;
+
+        // bits of 2/pi above 'first' only add multiples of 4 to |x| * 2/pi,
+        // so product modulo 2^128 keeps quadrant in two top bits, fraction below
+        const int first = exponent - 1;
+        const std::uint64_t window_hi = two_over_pi_window(first);
+        const std::uint64_t window_lo = two_over_pi_window(first + 64);
+        uint128_words product = multiply_wide(mantissa, window_lo);
+        product.hi += mantissa * window_hi;
+
+        // round to nearest quadrant, fraction becomes signed: top bit set means fraction - 1
+        uint128_words fraction = {(product.hi << 2) | (product.lo >> 62), product.lo << 2};
+        const bool round_up = (fraction.hi >> 63) != 0;
+        int result_quadrant = static_cast<int>(product.hi >> 62) + (round_up ? 1 : 0);
+        if (round_up)
+            fraction = {~fraction.hi + (fraction.lo == 0 ? 1 : 0), ~fraction.lo + 1};
+        // leading 64 bits with sticky bit of the rest round to double once
+        const int leading_zeros = fraction.hi != 0 ? std::countl_zero(fraction.hi) : 64 + std::countl_zero(fraction.lo);
+        double magnitude = 0;
+        if (leading_zeros < 128)
+        {
+            const int shift = leading_zeros % 64;
+            const std::uint64_t upper = leading_zeros < 64 ? fraction.hi : fraction.lo;
+            const std::uint64_t lower = leading_zeros < 64 ? fraction.lo : 0;
+            const std::uint64_t top = shift == 0 ? upper : (upper << shift) | (lower >> (64 - shift));
+            const bool sticky = (lower << shift) != 0;
+            const double scale = std::bit_cast<double>(static_cast<std::uint64_t>(1023 - 64 - leading_zeros) << 52);
+            magnitude = static_cast<double>(top | (sticky ? 1 : 0)) * scale;
+        }
+        double result = (round_up ? -magnitude : magnitude) * 0x1.921fb54442d18p+0;
+
+        if (x < 0)
+        {
+            result_quadrant = -result_quadrant;
+            result = -result;
+        }
+        quadrant = result_quadrant & 3;
+        return result;
+    }
+
+    /// \brief Payne-Hanek reduction of lanes beyond Cody-Waite limit, others are kept
+    template<typename computation_type>
+    [[gnu::cold, gnu::noinline]] void reduce_payne_hanek_lanes(const computation_type* x, computation_type* reduced, computation_type* quadrant, std::size_t count)
+    {
+        using constants = reduction_constants<computation_type>;
+        for (std::size_t lane = 0; lane < count; ++lane)
+        {
+            if (x[lane] <= constants::limit && x[lane] >= -constants::limit)
+                continue;
+
+            int lane_quadrant = 0;
+            reduced[lane] = static_cast<computation_type>(reduce_payne_hanek(static_cast<double>(x[lane]), lane_quadrant));
+            quadrant[lane] = static_cast<computation_type>(lane_quadrant);
+        }
+    }
+
+    /// \brief reduces x to r in [-pi/4, pi/4]: x = r + (quadrant + 4k) * pi/2
+    /// quadrant is in {0, 1, 2, 3}, stored in value_type to keep everything in one register type.
+    /// Cody-Waite reduction, lanes beyond its limit fall back to scalar Payne-Hanek
+    /// unless 'range' keeps arguments within the limit
+    template<typename computation_type, typename range = argument_range::unbounded, typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr void reduce_quadrant(const value_type& x, value_type& reduced, value_type& quadrant)
+    {
+        using constants = reduction_constants<computation_type>;
+
+        const value_type k = simd::round(x * constants::two_over_pi);
+        reduced = ((x - k * constants::pi_2_hi) - k * constants::pi_2_mid) - k * constants::pi_2_lo;
+        quadrant = k - simd::floor(k * static_cast<computation_type>(0.25)) * 4;
+
+        if constexpr (!argument_range::within<range>(constants::limit))
+        {
+            const auto beyond_limit = !(simd::abs(x) <= constants::limit);
+            if (simd::any(beyond_limit)) [[unlikely]]
+            {
+                if constexpr (std::is_arithmetic_v<value_type>)
+                {
+                    int lane_quadrant = 0;
+                    reduced = static_cast<computation_type>(reduce_payne_hanek(static_cast<double>(x), lane_quadrant));
+                    quadrant = static_cast<computation_type>(lane_quadrant);
+                }
+                else
+                {
+                    // lanes go through memory: indexing packs by lane makes compiler split them into scalars
+                    constexpr std::size_t lanes = simd::lane_count<value_type>;
+                    computation_type x_lanes[lanes];
+                    computation_type reduced_lanes[lanes];
+                    computation_type quadrant_lanes[lanes];
+                    std::memcpy(x_lanes, &x, sizeof(x_lanes));
+                    std::memcpy(reduced_lanes, &reduced, sizeof(reduced_lanes));
+                    std::memcpy(quadrant_lanes, &quadrant, sizeof(quadrant_lanes));
+                    reduce_payne_hanek_lanes(x_lanes, reduced_lanes, quadrant_lanes, lanes);
+                    std::memcpy(&reduced, reduced_lanes, sizeof(reduced_lanes));
+                    std::memcpy(&quadrant, quadrant_lanes, sizeof(quadrant_lanes));
+                }
+            }
+        }
+    }
+}
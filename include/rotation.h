@@ -0,0 +1,244 @@
+#pragma once
+
+#include "simd.h"
+#include "trigonometry.h"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <span>
+
+namespace _rotation_detail
+{
+    template<typename computation_type, std::size_t n, typename evaluation_policy>
+    using sincos_kernel = _math_detail::sincos_kernel<computation_type, n, evaluation_policy>;
+
+    /// \brief (x, y) rotated counterclockwise by angle
+    template<typename computation_type, std::size_t n, typename evaluation_policy>
+    struct rotate_2d_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static void apply(const value_type& angle, const value_type& x, const value_type& y,
+            value_type& o_x, value_type& o_y)
+        {
+            value_type sin{};
+            value_type cos{};
+            sincos_kernel<computation_type, n, evaluation_policy>::apply(angle, sin, cos);
+            o_x = x * cos - y * sin;
+            o_y = x * sin + y * cos;
+        }
+    };
+
+    /// \brief sin and 1 - cos of angle from sin and cos of angle / 2: versine 2 sin^2(angle / 2)
+    /// keeps its digits for small angles, where 1 - cos cancels
+    template<typename computation_type, std::size_t n, typename evaluation_policy, typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr void sin_versine(const value_type& angle, value_type& o_sin, value_type& o_versine)
+    {
+        value_type half_sin{};
+        value_type half_cos{};
+        sincos_kernel<computation_type, n, evaluation_policy>::apply(angle * static_cast<computation_type>(0.5), half_sin, half_cos);
+        const value_type twice_half_sin = half_sin + half_sin;
+        o_sin = twice_half_sin * half_cos;
+        o_versine = twice_half_sin * half_sin;
+    }
+
+    /// \brief point p rotated by angle about unit axis k (Rodrigues): p + sin (k x p) + (1 - cos) k x (k x p)
+    template<typename computation_type, std::size_t n, typename evaluation_policy>
+    struct rotate_axis_angle_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static void apply(const value_type& angle,
+            const value_type& kx, const value_type& ky, const value_type& kz,
+            const value_type& px, const value_type& py, const value_type& pz, std::array<value_type, 3>& o_point)
+        {
+            value_type sin{};
+            value_type versine{};
+            sin_versine<computation_type, n, evaluation_policy>(angle, sin, versine);
+
+            const value_type cx = ky * pz - kz * py;
+            const value_type cy = kz * px - kx * pz;
+            const value_type cz = kx * py - ky * px;
+            const value_type ccx = ky * cz - kz * cy;
+            const value_type ccy = kz * cx - kx * cz;
+            const value_type ccz = kx * cy - ky * cx;
+            o_point[0] = px + sin * cx + versine * ccx;
+            o_point[1] = py + sin * cy + versine * ccy;
+            o_point[2] = pz + sin * cz + versine * ccz;
+        }
+    };
+
+    /// \brief unit quaternion (w, x, y, z) of rotation by angle about unit axis k
+    template<typename computation_type, std::size_t n, typename evaluation_policy>
+    struct axis_angle_quaternion_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static void apply(const value_type& angle,
+            const value_type& kx, const value_type& ky, const value_type& kz, std::array<value_type, 4>& o_quaternion)
+        {
+            value_type half_sin{};
+            value_type half_cos{};
+            sincos_kernel<computation_type, n, evaluation_policy>::apply(angle * static_cast<computation_type>(0.5), half_sin, half_cos);
+            o_quaternion = { half_cos, kx * half_sin, ky * half_sin, kz * half_sin };
+        }
+    };
+
+    /// \brief row-major rotation matrix of rotation by angle about unit axis k
+    template<typename computation_type, std::size_t n, typename evaluation_policy>
+    struct axis_angle_matrix_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static void apply(const value_type& angle,
+            const value_type& kx, const value_type& ky, const value_type& kz, std::array<value_type, 9>& o_matrix)
+        {
+            value_type sin{};
+            value_type versine{};
+            sin_versine<computation_type, n, evaluation_policy>(angle, sin, versine);
+
+            const value_type tx = versine * kx;
+            const value_type ty = versine * ky;
+            const value_type tz = versine * kz;
+            const value_type sx = sin * kx;
+            const value_type sy = sin * ky;
+            const value_type sz = sin * kz;
+            // diagonal 1 - versine (1 - k^2) keeps digits of small angles
+            o_matrix = {
+                tx * kx - versine + 1, tx * ky - sz, tx * kz + sy,
+                tx * ky + sz, ty * ky - versine + 1, ty * kz - sx,
+                tx * kz - sy, ty * kz + sx, tz * kz - versine + 1 };
+        }
+    };
+
+    /// \brief unit quaternion of Euler angles, yaw about z, then pitch about y, then roll about x (intrinsic z-y'-x'')
+    template<typename computation_type, std::size_t n, typename evaluation_policy>
+    struct euler_quaternion_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static void apply(const value_type& roll, const value_type& pitch, const value_type& yaw,
+            std::array<value_type, 4>& o_quaternion)
+        {
+            using kernel = sincos_kernel<computation_type, n, evaluation_policy>;
+            constexpr computation_type half = static_cast<computation_type>(0.5);
+            value_type sr{}, cr{}, sp{}, cp{}, sy{}, cy{};
+            kernel::apply(roll * half, sr, cr);
+            kernel::apply(pitch * half, sp, cp);
+            kernel::apply(yaw * half, sy, cy);
+
+            const value_type cp_cy = cp * cy;
+            const value_type sp_sy = sp * sy;
+            const value_type sp_cy = sp * cy;
+            const value_type cp_sy = cp * sy;
+            o_quaternion = {
+                cr * cp_cy + sr * sp_sy,
+                sr * cp_cy - cr * sp_sy,
+                cr * sp_cy + sr * cp_sy,
+                cr * cp_sy - sr * sp_cy };
+        }
+    };
+
+    /// \brief row-major matrix Rz(yaw) Ry(pitch) Rx(roll) of Euler angles
+    template<typename computation_type, std::size_t n, typename evaluation_policy>
+    struct euler_matrix_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static void apply(const value_type& roll, const value_type& pitch, const value_type& yaw,
+            std::array<value_type, 9>& o_matrix)
+        {
+            using kernel = sincos_kernel<computation_type, n, evaluation_policy>;
+            value_type sr{}, cr{}, sp{}, cp{}, sy{}, cy{};
+            kernel::apply(roll, sr, cr);
+            kernel::apply(pitch, sp, cp);
+            kernel::apply(yaw, sy, cy);
+
+            const value_type sp_sr = sp * sr;
+            const value_type sp_cr = sp * cr;
+            o_matrix = {
+                cy * cp, cy * sp_sr - sy * cr, cy * sp_cr + sy * sr,
+                sy * cp, sy * sp_sr + cy * cr, sy * sp_cr - cy * sr,
+                -sp, cp * sr, cp * cr };
+        }
+    };
+}
+
+/// \brief Batch rotations straight from angle arrays
+/// Kernels evaluate sin and cos polynomials of trigonometry in registers and feed them to the rotation
+/// multiply-adds, so no sin or cos array reaches memory. Points, axes, quaternions (w, x, y, z) and
+/// row-major 3x3 matrices are structures of arrays; axes must be unit vectors. Results at index i
+/// are written after all inputs at index i are read, so a result array may be its input array.
+template<typename computation_type, std::size_t polynomial_size, typename evaluation_policy = polynomial_evaluation::horner,
+    typename storage_type = computation_type>
+struct rotation
+{
+    using vector_arrays = std::array<std::span<const storage_type>, 3>;
+    using vector_results = std::array<std::span<storage_type>, 3>;
+    using quaternion_results = std::array<std::span<storage_type>, 4>;
+    using matrix_results = std::array<std::span<storage_type>, 9>;
+
+    /// \brief 2D points (x, y) rotated counterclockwise by angle
+    static void rotate(std::span<const storage_type> angle, std::span<const storage_type> x, std::span<const storage_type> y,
+        std::span<storage_type> result_x, std::span<storage_type> result_y)
+    {
+        assert(x.size() == angle.size() && y.size() == angle.size());
+        assert(result_x.size() >= angle.size() && result_y.size() >= angle.size());
+        simd::transform_pair<_rotation_detail::rotate_2d_kernel<computation_type, polynomial_size, evaluation_policy>, computation_type>(
+            angle.size(), result_x.data(), result_y.data(), angle.data(), x.data(), y.data());
+    }
+
+    /// \brief 3D points rotated by angle about axis
+    static void rotate(std::span<const storage_type> angle, const vector_arrays& axis, const vector_arrays& points, const vector_results& result)
+    {
+        assert(sizes_match(angle.size(), axis) && sizes_match(angle.size(), points));
+        simd::transform_outputs<_rotation_detail::rotate_axis_angle_kernel<computation_type, polynomial_size, evaluation_policy>, computation_type>(
+            angle.size(), result_pointers(angle.size(), result), angle.data(), axis[0].data(), axis[1].data(), axis[2].data(),
+            points[0].data(), points[1].data(), points[2].data());
+    }
+
+    static void axis_angle_to_quaternion(std::span<const storage_type> angle, const vector_arrays& axis, const quaternion_results& result)
+    {
+        assert(sizes_match(angle.size(), axis));
+        simd::transform_outputs<_rotation_detail::axis_angle_quaternion_kernel<computation_type, polynomial_size, evaluation_policy>, computation_type>(
+            angle.size(), result_pointers(angle.size(), result), angle.data(), axis[0].data(), axis[1].data(), axis[2].data());
+    }
+
+    static void axis_angle_to_matrix(std::span<const storage_type> angle, const vector_arrays& axis, const matrix_results& result)
+    {
+        assert(sizes_match(angle.size(), axis));
+        simd::transform_outputs<_rotation_detail::axis_angle_matrix_kernel<computation_type, polynomial_size, evaluation_policy>, computation_type>(
+            angle.size(), result_pointers(angle.size(), result), angle.data(), axis[0].data(), axis[1].data(), axis[2].data());
+    }
+
+    /// \brief Euler angles, yaw about z, then pitch about y, then roll about x (intrinsic z-y'-x'')
+    static void euler_to_quaternion(std::span<const storage_type> roll, std::span<const storage_type> pitch, std::span<const storage_type> yaw,
+        const quaternion_results& result)
+    {
+        assert(pitch.size() == roll.size() && yaw.size() == roll.size());
+        simd::transform_outputs<_rotation_detail::euler_quaternion_kernel<computation_type, polynomial_size, evaluation_policy>, computation_type>(
+            roll.size(), result_pointers(roll.size(), result), roll.data(), pitch.data(), yaw.data());
+    }
+
+    /// \brief matrix Rz(yaw) Ry(pitch) Rx(roll)
+    static void euler_to_matrix(std::span<const storage_type> roll, std::span<const storage_type> pitch, std::span<const storage_type> yaw,
+        const matrix_results& result)
+    {
+        assert(pitch.size() == roll.size() && yaw.size() == roll.size());
+        simd::transform_outputs<_rotation_detail::euler_matrix_kernel<computation_type, polynomial_size, evaluation_policy>, computation_type>(
+            roll.size(), result_pointers(roll.size(), result), roll.data(), pitch.data(), yaw.data());
+    }
+
+private:
+    static bool sizes_match(std::size_t count, const vector_arrays& arrays)
+    {
+        return arrays[0].size() == count && arrays[1].size() == count && arrays[2].size() == count;
+    }
+
+    template<std::size_t output_count>
+    static std::array<storage_type*, output_count> result_pointers([[maybe_unused]] std::size_t count, const std::array<std::span<storage_type>, output_count>& results)
+    {
+        std::array<storage_type*, output_count> pointers{};
+        for (std::size_t o = 0; o < output_count; ++o)
+        {
+            assert(results[o].size() >= count);
+            pointers[o] = results[o].data();
+        }
+        return pointers;
+    }
+};
@@ -0,0 +1,1004 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#if defined(__GNUC__)
+#define TRIGONOMETRY_SIMD 1
+#define TRIGONOMETRY_FORCE_INLINE [[gnu::always_inline]] inline
+#else
+#define TRIGONOMETRY_FORCE_INLINE inline
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TRIGONOMETRY_SIMD_X86 1
+// declares builtins of every instruction set, e.g. gathers, whatever target translation unit has
+#include <immintrin.h>
+#endif
+
+#if defined(__FLT16_MAX__)
+#define TRIGONOMETRY_FLOAT16 1
+#endif
+
+namespace simd
+{
+    /// \brief instruction sets batch kernels are compiled for
+    enum class instruction_set
+    {
+        scalar,
+        sse2,
+        avx2,
+        avx512
+    };
+
+    /// \brief widest instruction set supported by running CPU
+    /// detection is done once and cached
+    inline instruction_set detect_instruction_set()
+    {
+        static const instruction_set detected = []()
+        {
+#if defined(TRIGONOMETRY_SIMD_X86)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("fma"))
+                return instruction_set::avx512;
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                return instruction_set::avx2;
+            if (__builtin_cpu_supports("sse2"))
+                return instruction_set::sse2;
+#endif
+            return instruction_set::scalar;
+        }();
+        return detected;
+    }
+
+    namespace _detail
+    {
+        /// read by every batch call, so atomic: forcing may race with batches running on other threads
+        inline std::atomic<instruction_set>& forced_instruction_set()
+        {
+            static std::atomic<instruction_set> forced{detect_instruction_set()};
+            return forced;
+        }
+    }
+
+    /// \brief instruction set used by batch functions
+    inline instruction_set active_instruction_set()
+    {
+        return _detail::forced_instruction_set().load(std::memory_order_relaxed);
+    }
+
+    /// \brief restricts batch functions to given instruction set
+    /// request is clamped to what running CPU supports; mostly useful for benchmarks.
+    /// Batches already running keep instruction set they started with
+    inline void force_instruction_set(instruction_set requested)
+    {
+        const instruction_set detected = detect_instruction_set();
+        _detail::forced_instruction_set().store(requested < detected ? requested : detected, std::memory_order_relaxed);
+    }
+
+    namespace _detail
+    {
+        /// \brief float bits to bfloat16 bits in low half, round to nearest even
+        /// bits_type is scalar or vector of 32 bit lanes, upper half of result is garbage for vectors;
+        /// vectors are returned through reference, by value they change calling convention
+        template<typename bits_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr void float_to_bfloat16_bits(const bits_type& bits, bits_type& result)
+        {
+            const bits_type rounded = (bits + 0x7fff + ((bits >> 16) & 1)) >> 16;
+            const bits_type quiet_nan = (bits >> 16) | 0x40;
+            if constexpr (std::is_integral_v<bits_type>)
+                result = (bits & 0x7fffffff) > 0x7f800000 ? quiet_nan : rounded;
+            else
+            {
+                const bits_type nan = (bits & 0x7fffffff) > 0x7f800000;
+                result = (nan & quiet_nan) | (~nan & rounded);
+            }
+        }
+    }
+
+    /// \brief bfloat16 storage: upper half of float bits
+    /// only storage, arithmetic is done after conversion to float;
+    /// conversion from float rounds to nearest even and keeps NaN quiet
+    struct bfloat16
+    {
+        std::uint16_t bits;
+
+        bfloat16() = default;
+
+        constexpr explicit bfloat16(float value) :
+            bits(0)
+        {
+            std::uint32_t converted = 0;
+            _detail::float_to_bfloat16_bits(std::bit_cast<std::uint32_t>(value), converted);
+            bits = static_cast<std::uint16_t>(converted);
+        }
+
+        constexpr explicit operator float() const
+        {
+            return std::bit_cast<float>(static_cast<std::uint32_t>(bits) << 16);
+        }
+    };
+
+#if defined(TRIGONOMETRY_FLOAT16)
+    /// \brief IEEE binary16 storage
+    using float16 = _Float16;
+#endif
+
+    /// \brief true for 16 bit storage types converted to float in registers by batch kernels
+    template<typename storage_type>
+    inline constexpr bool is_half_storage = std::is_same_v<storage_type, bfloat16>
+#if defined(TRIGONOMETRY_FLOAT16)
+        || std::is_same_v<storage_type, float16>
+#endif
+        ;
+
+    /// \brief value converted between storage and computation types
+    template<typename target_type, typename source_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr target_type convert(const source_type& value)
+    {
+        return static_cast<target_type>(value);
+    }
+
+    /// \brief scalar type of value, value may be scalar or pack
+    template<typename value_type>
+    struct element
+    {
+        using type = value_type;
+    };
+
+    template<typename value_type>
+    using element_type = typename element<value_type>::type;
+
+    /// \brief number of lanes in value
+    template<typename value_type>
+    inline constexpr std::size_t lane_count = 1;
+
+    /// \brief true if condition holds in any lane
+    TRIGONOMETRY_FORCE_INLINE constexpr bool any(bool condition)
+    {
+        return condition;
+    }
+
+    /// \brief scalar in given lane
+    template<typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr element_type<value_type> get_lane(const value_type& v, std::size_t)
+    {
+        return v;
+    }
+
+    template<typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr void set_lane(value_type& v, std::size_t, element_type<value_type> scalar)
+    {
+        v = scalar;
+    }
+
+    /// \brief lane-wise choice: condition ? if_true : if_false
+    /// for scalars condition is bool
+    template<typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr value_type select(bool condition, const value_type& if_true, const value_type& if_false)
+    {
+        return condition ? if_true : if_false;
+    }
+
+#if defined(TRIGONOMETRY_SIMD)
+    template<typename scalar_type, std::size_t width>
+    struct mask;
+
+    /// \brief fixed width vector of 'width' scalars
+    /// kernels are written once against scalar and pack arithmetic. Packs are
+    /// always passed by reference: wide vectors passed by value change calling
+    /// convention depending on instruction set.
+    template<typename scalar_type, std::size_t width>
+    struct pack
+    {
+        using integer_type = std::conditional_t<sizeof(scalar_type) == 2, std::int16_t,
+            std::conditional_t<sizeof(scalar_type) == 4, std::int32_t, std::int64_t>>;
+
+        typedef scalar_type native_type __attribute__((vector_size(sizeof(scalar_type) * width)));
+        typedef integer_type native_integer_type __attribute__((vector_size(sizeof(scalar_type) * width)));
+
+        native_type value;
+
+        TRIGONOMETRY_FORCE_INLINE static pack load(const scalar_type* data)
+        {
+            pack result;
+            std::memcpy(&result.value, data, sizeof(native_type));
+            return result;
+        }
+
+        TRIGONOMETRY_FORCE_INLINE void store(scalar_type* data) const
+        {
+            std::memcpy(data, &value, sizeof(native_type));
+        }
+
+        TRIGONOMETRY_FORCE_INLINE pack& operator+=(const pack& other) { value += other.value; return *this; }
+        TRIGONOMETRY_FORCE_INLINE pack& operator-=(const pack& other) { value -= other.value; return *this; }
+        TRIGONOMETRY_FORCE_INLINE pack& operator*=(const pack& other) { value *= other.value; return *this; }
+        TRIGONOMETRY_FORCE_INLINE pack& operator/=(const pack& other) { value /= other.value; return *this; }
+        TRIGONOMETRY_FORCE_INLINE pack& operator+=(scalar_type other) { value += other; return *this; }
+        TRIGONOMETRY_FORCE_INLINE pack& operator-=(scalar_type other) { value -= other; return *this; }
+        TRIGONOMETRY_FORCE_INLINE pack& operator*=(scalar_type other) { value *= other; return *this; }
+        TRIGONOMETRY_FORCE_INLINE pack& operator/=(scalar_type other) { value /= other; return *this; }
+    };
+
+    /// \brief lane-wise comparison result of two packs
+    template<typename scalar_type, std::size_t width>
+    struct mask
+    {
+        typename pack<scalar_type, width>::native_integer_type value;
+    };
+
+    template<typename scalar_type, std::size_t width>
+    struct element<pack<scalar_type, width>>
+    {
+        using type = scalar_type;
+    };
+
+    template<typename scalar_type, std::size_t lanes>
+    inline constexpr std::size_t lane_count<pack<scalar_type, lanes>> = lanes;
+
+    template<typename scalar_type, std::size_t width>
+    TRIGONOMETRY_FORCE_INLINE bool any(const mask<scalar_type, width>& condition)
+    {
+        constexpr std::size_t words = sizeof(condition.value) / sizeof(std::uint64_t);
+        std::uint64_t bits[words];
+        std::memcpy(bits, &condition.value, sizeof(bits));
+        std::uint64_t merged = 0;
+        for (std::size_t i = 0; i < words; ++i)
+            merged |= bits[i];
+        return merged != 0;
+    }
+
+    template<typename scalar_type, std::size_t width>
+    TRIGONOMETRY_FORCE_INLINE scalar_type get_lane(const pack<scalar_type, width>& v, std::size_t lane)
+    {
+        return v.value[lane];
+    }
+
+    template<typename scalar_type, std::size_t width>
+    TRIGONOMETRY_FORCE_INLINE void set_lane(pack<scalar_type, width>& v, std::size_t lane, scalar_type scalar)
+    {
+        v.value[lane] = scalar;
+    }
+
+#define TRIGONOMETRY_PACK_ARITHMETIC(op) \
+    template<typename scalar_type, std::size_t width> \
+    TRIGONOMETRY_FORCE_INLINE pack<scalar_type, width> operator op(const pack<scalar_type, width>& a, const pack<scalar_type, width>& b) \
+    { return { a.value op b.value }; } \
+    template<typename scalar_type, std::size_t width> \
+    TRIGONOMETRY_FORCE_INLINE pack<scalar_type, width> operator op(const pack<scalar_type, width>& a, std::type_identity_t<scalar_type> b) \
+    { return { a.value op b }; } \
+    template<typename scalar_type, std::size_t width> \
+    TRIGONOMETRY_FORCE_INLINE pack<scalar_type, width> operator op(std::type_identity_t<scalar_type> a, const pack<scalar_type, width>& b) \
+    { return { a op b.value }; }
+
+#define TRIGONOMETRY_PACK_COMPARISON(op) \
+    template<typename scalar_type, std::size_t width> \
+    TRIGONOMETRY_FORCE_INLINE mask<scalar_type, width> operator op(const pack<scalar_type, width>& a, const pack<scalar_type, width>& b) \
+    { return { a.value op b.value }; } \
+    template<typename scalar_type, std::size_t width> \
+    TRIGONOMETRY_FORCE_INLINE mask<scalar_type, width> operator op(const pack<scalar_type, width>& a, std::type_identity_t<scalar_type> b) \
+    { return { a.value op b }; } \
+    template<typename scalar_type, std::size_t width> \
+    TRIGONOMETRY_FORCE_INLINE mask<scalar_type, width> operator op(std::type_identity_t<scalar_type> a, const pack<scalar_type, width>& b) \
+    { return { a op b.value }; }
+
+    TRIGONOMETRY_PACK_ARITHMETIC(+)
+    TRIGONOMETRY_PACK_ARITHMETIC(-)
+    TRIGONOMETRY_PACK_ARITHMETIC(*)
+    TRIGONOMETRY_PACK_ARITHMETIC(/)
+
+    // integer packs only
+    TRIGONOMETRY_PACK_ARITHMETIC(&)
+    TRIGONOMETRY_PACK_ARITHMETIC(|)
+    TRIGONOMETRY_PACK_ARITHMETIC(^)
+    TRIGONOMETRY_PACK_ARITHMETIC(<<)
+    TRIGONOMETRY_PACK_ARITHMETIC(>>)
+
+    TRIGONOMETRY_PACK_COMPARISON(<)
+    TRIGONOMETRY_PACK_COMPARISON(<=)
+    TRIGONOMETRY_PACK_COMPARISON(>)
+    TRIGONOMETRY_PACK_COMPARISON(>=)
+    TRIGONOMETRY_PACK_COMPARISON(==)
+    TRIGONOMETRY_PACK_COMPARISON(!=)
+
+#undef TRIGONOMETRY_PACK_ARITHMETIC
+#undef TRIGONOMETRY_PACK_COMPARISON
+
+    template<typename scalar_type, std::size_t width>
+    TRIGONOMETRY_FORCE_INLINE pack<scalar_type, width> operator-(const pack<scalar_type, width>& a)
+    {
+        return { -a.value };
+    }
+
+    template<typename scalar_type, std::size_t width>
+    TRIGONOMETRY_FORCE_INLINE mask<scalar_type, width> operator&&(const mask<scalar_type, width>& a, const mask<scalar_type, width>& b)
+    {
+        return { a.value & b.value };
+    }
+
+    template<typename scalar_type, std::size_t width>
+    TRIGONOMETRY_FORCE_INLINE mask<scalar_type, width> operator||(const mask<scalar_type, width>& a, const mask<scalar_type, width>& b)
+    {
+        return { a.value | b.value };
+    }
+
+    template<typename scalar_type, std::size_t width>
+    TRIGONOMETRY_FORCE_INLINE mask<scalar_type, width> operator!(const mask<scalar_type, width>& a)
+    {
+        return { ~a.value };
+    }
+
+    template<typename scalar_type, std::size_t width>
+    TRIGONOMETRY_FORCE_INLINE pack<scalar_type, width> select(const mask<scalar_type, width>& condition, const pack<scalar_type, width>& if_true, const pack<scalar_type, width>& if_false)
+    {
+        // bitwise blend: vector ?: is split into lanes by GCC for 512-bit masks
+        using native_type = typename pack<scalar_type, width>::native_type;
+        using integer_vector = typename pack<scalar_type, width>::native_integer_type;
+        const integer_vector bits = (condition.value & (integer_vector)if_true.value) | (~condition.value & (integer_vector)if_false.value);
+        return { (native_type)bits };
+    }
+#endif
+
+    /// \brief value with every lane set to 'scalar'
+    template<typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr value_type broadcast(element_type<value_type> scalar)
+    {
+        if constexpr (std::is_arithmetic_v<value_type>)
+            return scalar;
+        else
+            // -0 base keeps sign of zero scalars, -0 + x is x for every float
+            return value_type{ -typename value_type::native_type{} + scalar };
+    }
+
+    /// \brief absolute value
+    template<typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr value_type abs(const value_type& x)
+    {
+        return select(x < 0, -x, x);
+    }
+
+#if defined(TRIGONOMETRY_SIMD)
+    /// packs clear sign bit, which also keeps comparison count of kernels low
+    template<typename scalar_type, std::size_t width>
+    TRIGONOMETRY_FORCE_INLINE pack<scalar_type, width> abs(const pack<scalar_type, width>& x)
+    {
+        using native_type = typename pack<scalar_type, width>::native_type;
+        using integer_vector = typename pack<scalar_type, width>::native_integer_type;
+        using integer_type = typename pack<scalar_type, width>::integer_type;
+        constexpr integer_type magnitude_bits = std::numeric_limits<integer_type>::max();
+        return { (native_type)((integer_vector)x.value & magnitude_bits) };
+    }
+#endif
+
+    /// \brief magnitude of 'magnitude' with sign bit of 'sign', bit operations without comparison
+    template<typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr value_type copysign(const value_type& magnitude, const value_type& sign)
+    {
+        using bits_type = std::conditional_t<sizeof(value_type) == 4, std::uint32_t, std::uint64_t>;
+        constexpr bits_type sign_bit = bits_type(1) << (sizeof(value_type) * 8 - 1);
+        return std::bit_cast<value_type>(static_cast<bits_type>((std::bit_cast<bits_type>(magnitude) & ~sign_bit) | (std::bit_cast<bits_type>(sign) & sign_bit)));
+    }
+
+#if defined(TRIGONOMETRY_SIMD)
+    template<typename scalar_type, std::size_t width>
+    TRIGONOMETRY_FORCE_INLINE pack<scalar_type, width> copysign(const pack<scalar_type, width>& magnitude, const pack<scalar_type, width>& sign)
+    {
+        using native_type = typename pack<scalar_type, width>::native_type;
+        using integer_vector = typename pack<scalar_type, width>::native_integer_type;
+        using integer_type = typename pack<scalar_type, width>::integer_type;
+        constexpr integer_type magnitude_bits = std::numeric_limits<integer_type>::max();
+        return { (native_type)(((integer_vector)magnitude.value & magnitude_bits) | ((integer_vector)sign.value & ~magnitude_bits)) };
+    }
+#endif
+
+    /// \brief lane-wise value conversion to other scalar type, e.g. widening int32 to int64
+    template<typename target_scalar, typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr auto lane_cast(const value_type& v)
+    {
+        if constexpr (std::is_arithmetic_v<value_type>)
+            return static_cast<target_scalar>(v);
+#if defined(TRIGONOMETRY_SIMD)
+        else
+        {
+            using target_type = pack<target_scalar, lane_count<value_type>>;
+            return target_type{ __builtin_convertvector(v.value, typename target_type::native_type) };
+        }
+#endif
+    }
+
+    /// \brief same lane bits viewed as other scalar type of equal size, e.g. uint32 as int32
+    template<typename target_scalar, typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr auto reinterpret_lanes(const value_type& v)
+    {
+        static_assert(sizeof(target_scalar) == sizeof(element_type<value_type>));
+        if constexpr (std::is_arithmetic_v<value_type>)
+            return std::bit_cast<target_scalar>(v);
+#if defined(TRIGONOMETRY_SIMD)
+        else
+        {
+            using target_type = pack<target_scalar, lane_count<value_type>>;
+            return target_type{ (typename target_type::native_type)v.value };
+        }
+#endif
+    }
+
+    /// \brief rounds to nearest integer value, ties to even
+    template<typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr value_type round(const value_type& x)
+    {
+        using scalar_type = element_type<value_type>;
+        // values above 2^mantissa_bits have no fractional part
+        constexpr scalar_type integral_limit = static_cast<scalar_type>(1ull << (std::numeric_limits<scalar_type>::digits - 1));
+        constexpr scalar_type shifter = integral_limit + integral_limit / 2;
+
+        const value_type rounded = (x + shifter) - shifter;
+        return select(abs(x) < integral_limit, rounded, x);
+    }
+
+    /// \brief largest integer value not greater than x
+    template<typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr value_type floor(const value_type& x)
+    {
+        const value_type rounded = round(x);
+        return select(rounded > x, rounded - 1, rounded);
+    }
+
+    /// \brief lanes of result loaded from base[index], index holds integer lanes as wide as result's
+    /// 256 and 512 bit float and double packs use hardware gather, so they need avx2 or avx512 targets as
+    /// batch kernels of transform have; other packs load lane by lane
+    template<typename value_type, typename index_type>
+    TRIGONOMETRY_FORCE_INLINE void gather(const element_type<value_type>* base, const index_type& index, value_type& result)
+    {
+        using scalar_type = element_type<value_type>;
+        constexpr std::size_t bytes = sizeof(value_type);
+        static_assert(sizeof(element_type<index_type>) == sizeof(scalar_type));
+#if defined(TRIGONOMETRY_SIMD_X86)
+        // builtins return wide vectors: ABI note of -Wpsabi does not apply to always inlined code
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+        if constexpr (bytes == 32 || bytes == 64)
+        {
+            using native_type = typename value_type::native_type;
+            const native_type all_lanes = (native_type)(index.value == index.value);
+            if constexpr (std::is_same_v<scalar_type, float> && bytes == 32)
+                result.value = __builtin_ia32_gathersiv8sf(native_type{}, base, index.value, all_lanes, sizeof(float));
+            else if constexpr (std::is_same_v<scalar_type, double> && bytes == 32)
+            {
+                typedef long long index_vector __attribute__((vector_size(32)));
+                result.value = __builtin_ia32_gatherdiv4df(native_type{}, base, (index_vector)index.value, all_lanes, sizeof(double));
+            }
+            else if constexpr (std::is_same_v<scalar_type, float>)
+                result.value = __builtin_ia32_gathersiv16sf(native_type{}, base, index.value, 0xffff, sizeof(float));
+            else
+            {
+                typedef long long index_vector __attribute__((vector_size(64)));
+                result.value = __builtin_ia32_gatherdiv8df(native_type{}, base, (index_vector)index.value, 0xff, sizeof(double));
+            }
+            return;
+        }
+#pragma GCC diagnostic pop
+#endif
+        for (std::size_t lane = 0; lane < lane_count<value_type>; ++lane)
+            set_lane(result, lane, base[static_cast<std::size_t>(get_lane(index, lane))]);
+    }
+
+    /// \brief square root
+    /// scalars use hardware instruction, packs use reciprocal square root estimate
+    /// refined by Newton-Raphson iterations, which vectorizes on every instruction set
+    template<typename value_type>
+    TRIGONOMETRY_FORCE_INLINE value_type sqrt(const value_type& x)
+    {
+        if constexpr (std::is_arithmetic_v<value_type>)
+            return std::sqrt(x);
+#if defined(TRIGONOMETRY_SIMD)
+        else
+        {
+            using scalar_type = element_type<value_type>;
+            using integer_vector = typename value_type::native_integer_type;
+            using integer_type = typename value_type::integer_type;
+            constexpr bool is_float = sizeof(scalar_type) == 4;
+            constexpr std::size_t iterations = is_float ? 3 : 4;
+            constexpr integer_type magic = static_cast<integer_type>(is_float ? 0x5f375a86ll : 0x5fe6eb50c7b537a9ll);
+            constexpr scalar_type infinity = std::numeric_limits<scalar_type>::infinity();
+
+            const integer_vector guess_bits = magic - ((integer_vector)abs(x).value >> 1);
+            value_type y{ (typename value_type::native_type)guess_bits };
+
+            const value_type half_x = x * static_cast<scalar_type>(0.5);
+            for (std::size_t i = 0; i < iterations; ++i)
+                y = y * (static_cast<scalar_type>(1.5) - half_x * y * y);
+
+            // zero stays zero through x * y, negative and NaN become NaN, infinity is kept; two single
+            // comparisons: GCC turns more combined comparisons of 512 bit packs into scalar code
+            const value_type result = select(x >= 0, x * y, broadcast<value_type>(std::numeric_limits<scalar_type>::quiet_NaN()));
+            return select(x < infinity, result, x);
+        }
+#endif
+    }
+
+#if defined(TRIGONOMETRY_SIMD)
+    namespace _detail
+    {
+        /// \brief binary16 bits to float bits, 32 bit lanes with half in low 16 bits
+        template<typename integer_vector, typename float_vector>
+        TRIGONOMETRY_FORCE_INLINE void half_to_float_bits(const integer_vector& half, integer_vector& result)
+        {
+            const integer_vector sign = (half & 0x8000) << 16;
+            const integer_vector magnitude = half & 0x7fff;
+            const integer_vector normal = (magnitude << 13) + ((127 - 15) << 23);
+            const integer_vector special = (magnitude << 13) | 0x7f800000;
+            const integer_vector subnormal = (integer_vector)(__builtin_convertvector(magnitude, float_vector) * 0x1p-24f);
+
+            const integer_vector is_special = magnitude >= 0x7c00;
+            const integer_vector is_subnormal = magnitude < 0x400;
+            const integer_vector finite = (is_subnormal & subnormal) | (~is_subnormal & normal);
+            result = ((is_special & special) | (~is_special & finite)) | sign;
+        }
+
+        /// \brief float bits to binary16 bits in low 16 bits, round to nearest even
+        /// subnormal results are rounded by float addition of 0.5, which aligns them at bit 0
+        template<typename integer_vector, typename float_vector>
+        TRIGONOMETRY_FORCE_INLINE void float_to_half_bits(const integer_vector& bits, integer_vector& result)
+        {
+            constexpr std::int32_t infinity_bits = 0x7f800000;
+            constexpr std::int32_t overflow_bits = (127 + 16) << 23;
+            constexpr std::int32_t min_normal_bits = (127 - 14) << 23;
+            constexpr std::int32_t subnormal_magic_bits = (127 - 1) << 23;
+
+            const integer_vector sign = (bits >> 16) & 0x8000;
+            const integer_vector magnitude = bits & 0x7fffffff;
+            const integer_vector special = 0x7c00 | ((magnitude > infinity_bits) & 0x0200);
+            const integer_vector subnormal = (integer_vector)((float_vector)magnitude + 0.5f) - subnormal_magic_bits;
+            const integer_vector normal = (magnitude + (((15 - 127) << 23) + 0xfff) + ((magnitude >> 13) & 1)) >> 13;
+
+            const integer_vector is_special = magnitude >= overflow_bits;
+            const integer_vector is_subnormal = magnitude < min_normal_bits;
+            const integer_vector finite = (is_subnormal & subnormal) | (~is_subnormal & normal);
+            result = ((is_special & special) | (~is_special & finite)) | sign;
+        }
+
+        /// \brief pack of computation type from 'width' consecutive storage values
+        /// 16 bit storage is widened with integer operations, which vectorize on every instruction set
+        template<typename pack_type, typename storage_type>
+        TRIGONOMETRY_FORCE_INLINE pack_type load_converted(const storage_type* data)
+        {
+            using computation_type = element_type<pack_type>;
+            constexpr std::size_t width = lane_count<pack_type>;
+            using native_type = typename pack_type::native_type;
+            using integer_vector = typename pack_type::native_integer_type;
+
+            if constexpr (std::is_same_v<storage_type, computation_type>)
+                return pack_type::load(data);
+            else if constexpr (is_half_storage<storage_type>)
+            {
+                static_assert(std::is_same_v<computation_type, float>, "16 bit storage is computed in float");
+                typedef std::uint16_t storage_vector __attribute__((vector_size(sizeof(std::uint16_t) * width)));
+                storage_vector raw;
+                std::memcpy(&raw, data, sizeof(raw));
+                const integer_vector bits = __builtin_convertvector(raw, integer_vector);
+                if constexpr (std::is_same_v<storage_type, bfloat16>)
+                    return { (native_type)(bits << 16) };
+                else
+                {
+                    integer_vector converted;
+                    half_to_float_bits<integer_vector, native_type>(bits, converted);
+                    return { (native_type)converted };
+                }
+            }
+            else
+            {
+                typedef storage_type storage_vector __attribute__((vector_size(sizeof(storage_type) * width)));
+                storage_vector raw;
+                std::memcpy(&raw, data, sizeof(raw));
+                return { __builtin_convertvector(raw, native_type) };
+            }
+        }
+
+        /// \brief stores pack as 'width' consecutive storage values, rounding to nearest
+        template<typename pack_type, typename storage_type>
+        TRIGONOMETRY_FORCE_INLINE void store_converted(const pack_type& value, storage_type* data)
+        {
+            using computation_type = element_type<pack_type>;
+            constexpr std::size_t width = lane_count<pack_type>;
+            using native_type = typename pack_type::native_type;
+            using integer_vector = typename pack_type::native_integer_type;
+
+            if constexpr (std::is_same_v<storage_type, computation_type>)
+                value.store(data);
+            else if constexpr (is_half_storage<storage_type>)
+            {
+                static_assert(std::is_same_v<computation_type, float>, "16 bit storage is computed in float");
+                typedef std::uint16_t storage_vector __attribute__((vector_size(sizeof(std::uint16_t) * width)));
+                const integer_vector bits = (integer_vector)value.value;
+                integer_vector converted;
+                if constexpr (std::is_same_v<storage_type, bfloat16>)
+                    float_to_bfloat16_bits(bits, converted);
+                else
+                    float_to_half_bits<integer_vector, native_type>(bits, converted);
+                const storage_vector raw = __builtin_convertvector(converted, storage_vector);
+                std::memcpy(data, &raw, sizeof(raw));
+            }
+            else
+            {
+                typedef storage_type storage_vector __attribute__((vector_size(sizeof(storage_type) * width)));
+                const storage_vector raw = __builtin_convertvector(value.value, storage_vector);
+                std::memcpy(data, &raw, sizeof(raw));
+            }
+        }
+
+        /// \brief even (bit_offset 0) or odd (bit_offset 16) elements of 2 * width 16 bit storage values
+        /// loaded as whole 32 bit words: widening in place needs no lane crossing shuffles,
+        /// which load_converted spends most of its time on
+        template<typename pack_type, std::size_t bit_offset, typename storage_type>
+        TRIGONOMETRY_FORCE_INLINE pack_type load_interleaved(const storage_type* data)
+        {
+            using native_type = typename pack_type::native_type;
+            using integer_vector = typename pack_type::native_integer_type;
+
+            integer_vector words;
+            std::memcpy(&words, data, sizeof(words));
+            if constexpr (std::is_same_v<storage_type, bfloat16>)
+            {
+                if constexpr (bit_offset == 0)
+                    return { (native_type)(words << 16) };
+                else
+                    return { (native_type)(words & ~0xffff) };
+            }
+            else
+            {
+                // high half of every word is ignored by conversion
+                integer_vector converted;
+                half_to_float_bits<integer_vector, native_type>(bit_offset == 0 ? words : words >> 16, converted);
+                return { (native_type)converted };
+            }
+        }
+
+        /// \brief stores even and odd elements back as 2 * width 16 bit storage values
+        template<typename pack_type, typename storage_type>
+        TRIGONOMETRY_FORCE_INLINE void store_interleaved(const pack_type& even, const pack_type& odd, storage_type* data)
+        {
+            using native_type = typename pack_type::native_type;
+            using integer_vector = typename pack_type::native_integer_type;
+
+            integer_vector even_bits;
+            integer_vector odd_bits;
+            if constexpr (std::is_same_v<storage_type, bfloat16>)
+            {
+                float_to_bfloat16_bits((integer_vector)even.value, even_bits);
+                float_to_bfloat16_bits((integer_vector)odd.value, odd_bits);
+            }
+            else
+            {
+                float_to_half_bits<integer_vector, native_type>((integer_vector)even.value, even_bits);
+                float_to_half_bits<integer_vector, native_type>((integer_vector)odd.value, odd_bits);
+            }
+            const integer_vector words = (even_bits & 0xffff) | (odd_bits << 16);
+            std::memcpy(data, &words, sizeof(words));
+        }
+
+        /// \brief true if output and all inputs are 16 bit storage, which is converted by interleaved loads and stores
+        template<typename storage_type, typename... input_types>
+        inline constexpr bool interleaved_storage = is_half_storage<storage_type> && (is_half_storage<input_types> && ...);
+
+        template<typename pack_type, typename storage_type>
+        TRIGONOMETRY_FORCE_INLINE pack_type load_partial(const storage_type* data, std::size_t count)
+        {
+            storage_type buffer[lane_count<pack_type>]{};
+            std::memcpy(buffer, data, count * sizeof(storage_type));
+            return load_converted<pack_type>(buffer);
+        }
+
+        template<typename pack_type, typename storage_type>
+        TRIGONOMETRY_FORCE_INLINE void store_partial(const pack_type& value, storage_type* data, std::size_t count)
+        {
+            storage_type buffer[lane_count<pack_type>];
+            store_converted(value, buffer);
+            std::memcpy(data, buffer, count * sizeof(storage_type));
+        }
+
+        /// \brief applies kernel to whole packs of computation_type, the tail is zero-padded into packs
+        /// inputs and output are converted from and to their storage types in registers,
+        /// arrays of 16 bit storage only are processed two packs (even and odd elements) at a time
+        template<typename kernel, std::size_t bytes, typename computation_type, typename storage_type, typename... input_types>
+        TRIGONOMETRY_FORCE_INLINE void transform(const kernel& instance, std::size_t count, storage_type* out, const input_types*... in)
+        {
+            constexpr std::size_t width = bytes / sizeof(computation_type);
+            using pack_type = pack<computation_type, width>;
+
+            std::size_t i = 0;
+            if constexpr (interleaved_storage<storage_type, input_types...>)
+            {
+                for (; i + 2 * width <= count; i += 2 * width)
+                    store_interleaved(instance.apply(load_interleaved<pack_type, 0>(in + i)...),
+                        instance.apply(load_interleaved<pack_type, 16>(in + i)...), out + i);
+            }
+            else
+            {
+                for (; i + width <= count; i += width)
+                    store_converted(instance.apply(load_converted<pack_type>(in + i)...), out + i);
+            }
+            for (; i < count; i += width)
+            {
+                const std::size_t rest = count - i < width ? count - i : width;
+                store_partial(instance.apply(load_partial<pack_type>(in + i, rest)...), out + i, rest);
+            }
+        }
+
+        /// \brief kernel::apply(in..., first, second) writes two results per element, loops as in transform
+        template<typename kernel, std::size_t bytes, typename computation_type, typename storage_type, typename... input_types>
+        TRIGONOMETRY_FORCE_INLINE void transform_pair(std::size_t count, storage_type* first, storage_type* second, const input_types*... in)
+        {
+            constexpr std::size_t width = bytes / sizeof(computation_type);
+            using pack_type = pack<computation_type, width>;
+
+            std::size_t i = 0;
+            if constexpr (interleaved_storage<storage_type, input_types...>)
+            {
+                for (; i + 2 * width <= count; i += 2 * width)
+                {
+                    pack_type first_even{};
+                    pack_type second_even{};
+                    pack_type first_odd{};
+                    pack_type second_odd{};
+                    kernel::apply(load_interleaved<pack_type, 0>(in + i)..., first_even, second_even);
+                    kernel::apply(load_interleaved<pack_type, 16>(in + i)..., first_odd, second_odd);
+                    store_interleaved(first_even, first_odd, first + i);
+                    store_interleaved(second_even, second_odd, second + i);
+                }
+            }
+            else
+            {
+                for (; i + width <= count; i += width)
+                {
+                    pack_type first_result{};
+                    pack_type second_result{};
+                    kernel::apply(load_converted<pack_type>(in + i)..., first_result, second_result);
+                    store_converted(first_result, first + i);
+                    store_converted(second_result, second + i);
+                }
+            }
+            for (; i < count; i += width)
+            {
+                const std::size_t rest = count - i < width ? count - i : width;
+                pack_type first_result{};
+                pack_type second_result{};
+                kernel::apply(load_partial<pack_type>(in + i, rest)..., first_result, second_result);
+                store_partial(first_result, first + i, rest);
+                store_partial(second_result, second + i, rest);
+            }
+        }
+
+        /// \brief kernel::apply(in..., results) fills array of output_count results per element,
+        /// loops as in transform; 16 bit storage is converted pack by pack, without interleaving
+        template<typename kernel, std::size_t bytes, typename computation_type, typename storage_type, std::size_t output_count, typename... input_types>
+        TRIGONOMETRY_FORCE_INLINE void transform_outputs(std::size_t count, const std::array<storage_type*, output_count>& out, const input_types*... in)
+        {
+            constexpr std::size_t width = bytes / sizeof(computation_type);
+            using pack_type = pack<computation_type, width>;
+
+            std::size_t i = 0;
+            for (; i + width <= count; i += width)
+            {
+                std::array<pack_type, output_count> results{};
+                kernel::apply(load_converted<pack_type>(in + i)..., results);
+                for (std::size_t o = 0; o < output_count; ++o)
+                    store_converted(results[o], out[o] + i);
+            }
+            for (; i < count; i += width)
+            {
+                const std::size_t rest = count - i < width ? count - i : width;
+                std::array<pack_type, output_count> results{};
+                kernel::apply(load_partial<pack_type>(in + i, rest)..., results);
+                for (std::size_t o = 0; o < output_count; ++o)
+                    store_partial(results[o], out[o] + i, rest);
+            }
+        }
+
+#if defined(TRIGONOMETRY_SIMD_X86)
+        template<typename kernel, typename computation_type, typename storage_type, typename... input_types>
+        __attribute__((target("sse2"))) void transform_sse2(const kernel& instance, std::size_t count, storage_type* out, const input_types*... in)
+        {
+            transform<kernel, 16, computation_type>(instance, count, out, in...);
+        }
+
+        template<typename kernel, typename computation_type, typename storage_type, typename... input_types>
+        __attribute__((target("avx2,fma"))) void transform_avx2(const kernel& instance, std::size_t count, storage_type* out, const input_types*... in)
+        {
+            transform<kernel, 32, computation_type>(instance, count, out, in...);
+        }
+
+        template<typename kernel, typename computation_type, typename storage_type, typename... input_types>
+        __attribute__((target("avx512f,fma"))) void transform_avx512(const kernel& instance, std::size_t count, storage_type* out, const input_types*... in)
+        {
+            transform<kernel, 64, computation_type>(instance, count, out, in...);
+        }
+
+        template<typename kernel, typename computation_type, typename storage_type, typename... input_types>
+        __attribute__((target("sse2"))) void transform_pair_sse2(std::size_t count, storage_type* first, storage_type* second, const input_types*... in)
+        {
+            transform_pair<kernel, 16, computation_type>(count, first, second, in...);
+        }
+
+        template<typename kernel, typename computation_type, typename storage_type, typename... input_types>
+        __attribute__((target("avx2,fma"))) void transform_pair_avx2(std::size_t count, storage_type* first, storage_type* second, const input_types*... in)
+        {
+            transform_pair<kernel, 32, computation_type>(count, first, second, in...);
+        }
+
+        template<typename kernel, typename computation_type, typename storage_type, typename... input_types>
+        __attribute__((target("avx512f,fma"))) void transform_pair_avx512(std::size_t count, storage_type* first, storage_type* second, const input_types*... in)
+        {
+            transform_pair<kernel, 64, computation_type>(count, first, second, in...);
+        }
+
+        template<typename kernel, typename computation_type, typename storage_type, std::size_t output_count, typename... input_types>
+        __attribute__((target("sse2"))) void transform_outputs_sse2(std::size_t count, const std::array<storage_type*, output_count>& out, const input_types*... in)
+        {
+            transform_outputs<kernel, 16, computation_type>(count, out, in...);
+        }
+
+        template<typename kernel, typename computation_type, typename storage_type, std::size_t output_count, typename... input_types>
+        __attribute__((target("avx2,fma"))) void transform_outputs_avx2(std::size_t count, const std::array<storage_type*, output_count>& out, const input_types*... in)
+        {
+            transform_outputs<kernel, 32, computation_type>(count, out, in...);
+        }
+
+        template<typename kernel, typename computation_type, typename storage_type, std::size_t output_count, typename... input_types>
+        __attribute__((target("avx512f,fma"))) void transform_outputs_avx512(std::size_t count, const std::array<storage_type*, output_count>& out, const input_types*... in)
+        {
+            transform_outputs<kernel, 64, computation_type>(count, out, in...);
+        }
+
+        template<typename kernel, typename... argument_types>
+        __attribute__((target("sse2"))) void dispatch_sse2(argument_types... arguments)
+        {
+            kernel::template run<16>(arguments...);
+        }
+
+        template<typename kernel, typename... argument_types>
+        __attribute__((target("avx2,fma"))) void dispatch_avx2(argument_types... arguments)
+        {
+            kernel::template run<32>(arguments...);
+        }
+
+        template<typename kernel, typename... argument_types>
+        __attribute__((target("avx512f,fma"))) void dispatch_avx512(argument_types... arguments)
+        {
+            kernel::template run<64>(arguments...);
+        }
+#endif
+    }
+#endif
+
+    /// \brief out[i] = instance.apply(in[i]...) for i in [0, count)
+    /// for kernels carrying run time state, e.g. coefficients; dispatched and converted as transform below
+    template<typename computation_type = void, typename kernel, typename storage_type, typename... input_types>
+    void transform(const kernel& instance, std::size_t count, storage_type* out, const input_types*... in)
+    {
+        using kernel_type = std::conditional_t<std::is_void_v<computation_type>, storage_type, computation_type>;
+#if defined(TRIGONOMETRY_SIMD_X86)
+        switch (active_instruction_set())
+        {
+        case instruction_set::avx512:
+            _detail::transform_avx512<kernel, kernel_type>(instance, count, out, in...);
+            return;
+        case instruction_set::avx2:
+            _detail::transform_avx2<kernel, kernel_type>(instance, count, out, in...);
+            return;
+        case instruction_set::sse2:
+            _detail::transform_sse2<kernel, kernel_type>(instance, count, out, in...);
+            return;
+        case instruction_set::scalar:
+            break;
+        }
+#endif
+        for (std::size_t i = 0; i < count; ++i)
+            out[i] = convert<storage_type>(instance.apply(convert<kernel_type>(in[i])...));
+    }
+
+    /// \brief out[i] = kernel::apply(in[i]...) for i in [0, count)
+    /// uses widest instruction set allowed by active_instruction_set().
+    /// Kernel runs in 'computation_type' (void: type of out), inputs and output may be stored
+    /// in other types, e.g. float16 or bfloat16 for float computation, and are converted in registers
+    template<typename kernel, typename computation_type = void, typename storage_type, typename... input_types>
+    void transform(std::size_t count, storage_type* out, const input_types*... in)
+    {
+        transform<computation_type>(kernel{}, count, out, in...);
+    }
+
+    /// \brief kernel::apply(in[i]..., first[i], second[i]) for i in [0, count)
+    /// for kernels producing two results from shared work, dispatched and converted as transform
+    template<typename kernel, typename computation_type = void, typename storage_type, typename... input_types>
+    void transform_pair(std::size_t count, storage_type* first, storage_type* second, const input_types*... in)
+    {
+        using kernel_type = std::conditional_t<std::is_void_v<computation_type>, storage_type, computation_type>;
+#if defined(TRIGONOMETRY_SIMD_X86)
+        switch (active_instruction_set())
+        {
+        case instruction_set::avx512:
+            _detail::transform_pair_avx512<kernel, kernel_type>(count, first, second, in...);
+            return;
+        case instruction_set::avx2:
+            _detail::transform_pair_avx2<kernel, kernel_type>(count, first, second, in...);
+            return;
+        case instruction_set::sse2:
+            _detail::transform_pair_sse2<kernel, kernel_type>(count, first, second, in...);
+            return;
+        case instruction_set::scalar:
+            break;
+        }
+#endif
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            kernel_type first_result{};
+            kernel_type second_result{};
+            kernel::apply(convert<kernel_type>(in[i])..., first_result, second_result);
+            first[i] = convert<storage_type>(first_result);
+            second[i] = convert<storage_type>(second_result);
+        }
+    }
+
+    /// \brief kernel::apply(in[i]..., results) for i in [0, count), results[o] is stored to out[o][i]
+    /// for kernels producing several results from shared work, e.g. rotations; dispatched and converted as transform
+    template<typename kernel, typename computation_type = void, typename storage_type, std::size_t output_count, typename... input_types>
+    void transform_outputs(std::size_t count, const std::array<storage_type*, output_count>& out, const input_types*... in)
+    {
+        using kernel_type = std::conditional_t<std::is_void_v<computation_type>, storage_type, computation_type>;
+#if defined(TRIGONOMETRY_SIMD_X86)
+        switch (active_instruction_set())
+        {
+        case instruction_set::avx512:
+            _detail::transform_outputs_avx512<kernel, kernel_type>(count, out, in...);
+            return;
+        case instruction_set::avx2:
+            _detail::transform_outputs_avx2<kernel, kernel_type>(count, out, in...);
+            return;
+        case instruction_set::sse2:
+            _detail::transform_outputs_sse2<kernel, kernel_type>(count, out, in...);
+            return;
+        case instruction_set::scalar:
+            break;
+        }
+#endif
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::array<kernel_type, output_count> results{};
+            kernel::apply(convert<kernel_type>(in[i])..., results);
+            for (std::size_t o = 0; o < output_count; ++o)
+                out[o][i] = convert<storage_type>(results[o]);
+        }
+    }
+
+    /// \brief kernel::run<bytes>(arguments...) with pack size in bytes of widest instruction set allowed by
+    /// active_instruction_set(), run<0> (scalars only) without simd; for kernels that are not element-wise,
+    /// e.g. recurrences carrying state from pack to pack
+    template<typename kernel, typename... argument_types>
+    void dispatch(argument_types... arguments)
+    {
+#if defined(TRIGONOMETRY_SIMD_X86)
+        switch (active_instruction_set())
+        {
+        case instruction_set::avx512:
+            _detail::dispatch_avx512<kernel>(arguments...);
+            return;
+        case instruction_set::avx2:
+            _detail::dispatch_avx2<kernel>(arguments...);
+            return;
+        case instruction_set::sse2:
+            _detail::dispatch_sse2<kernel>(arguments...);
+            return;
+        case instruction_set::scalar:
+            break;
+        }
+#endif
+        kernel::template run<0>(arguments...);
+    }
+}
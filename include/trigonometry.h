@@ -1,108 +1,829 @@
 #pragma once
 
+#include "coefficient_table.h"
 #include "helper_math.h"
+#include "instrumentation.h"
+#include "parallel.h"
 #include "polynomial.h"
+#include "range_reduction.h"
+#include "simd.h"
 
+#include <array>
+#include <cassert>
 #include <cstddef>
 #include <cmath>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+// std::execution::par_unseq overloads are opt-in: with TBB installed <execution> makes
+// every user link against it
+#if defined(TRIGONOMETRY_EXECUTION_POLICIES)
+#include <execution>
+#endif
+
+/// \brief how scalar calls of trigonometry evaluate kernels
+namespace scalar_evaluation
+{
+    /// \brief kernels as written, compiler chooses branches or conditional moves for selects;
+    /// fastest when arguments are sorted or otherwise predictable
+    struct branching {};
+
+    /// \brief scalar argument runs through simd kernel in one 16 byte pack: selects are bitwise blends
+    /// and signs are copysign, so no branch depends on the argument (Payne-Hanek reduction of
+    /// arguments beyond Cody-Waite limit excepted). For random arguments; constant evaluation uses branching
+    struct branchless {};
+}
 
 namespace _math_detail
 {
+    using fit_type = polynomial_fit_detail::fit_type;
+
+    // reference functions for fitting, in u = r^2 on [0, (pi/4)^2]; series terms by recurrence
+    // until they stop changing the sum
+    constexpr fit_type cos_sqrt_reference(fit_type u)
+    {
+        // cos(sqrt(u)) = sum (-u)^k / (2k)!
+        fit_type term = 1;
+        fit_type sum = 1;
+        for (int k = 1; k < _math_helper::series_max_terms; ++k)
+        {
+            term *= -u / ((2*k - 1) * (2*k));
+            const fit_type next = sum + term;
+            if (next == sum)
+                break;
+            sum = next;
+        }
+        return sum;
+    }
+
+    constexpr fit_type sin_sqrt_reference(fit_type u)
+    {
+        // sin(sqrt(u)) / sqrt(u) = sum (-u)^k / (2k+1)!
+        fit_type term = 1;
+        fit_type sum = 1;
+        for (int k = 1; k < _math_helper::series_max_terms; ++k)
+        {
+            term *= -u / ((2*k) * (2*k + 1));
+            const fit_type next = sum + term;
+            if (next == sum)
+                break;
+            sum = next;
+        }
+        return sum;
+    }
+
+    constexpr fit_type asin_reference(fit_type x)
+    {
+        return _math_helper::asin(x);
+    }
+
+    constexpr fit_type atan_reference(fit_type z)
+    {
+        // atan(z) = pi/4 + atan((z - 1) / (z + 1)) keeps series argument below tan(pi/8) for z in [0, 1]
+        constexpr fit_type pi_4 = 0.785398163397448309615660845819875721l;
+        const bool shifted = z > 0.4142135623730950488l;
+        const fit_type w = shifted ? (z - 1) / (z + 1) : z;
+
+        // atan(w) = sum (-1)^k w^(2k+1) / (2k+1)
+        const fit_type w2 = w * w;
+        fit_type power = w;
+        fit_type sum = w;
+        for (int k = 1; k < 2 * _math_helper::series_max_terms; ++k)
+        {
+            power *= -w2;
+            const fit_type next = sum + power / (2*k + 1);
+            if (next == sum)
+                break;
+            sum = next;
+        }
+        return shifted ? pi_4 + sum : sum;
+    }
+
+    constexpr fit_type atan_sqrt_reference(fit_type u)
+    {
+        // atan(sqrt(u)) / sqrt(u) on [0, 1]
+        if (u == 0)
+            return 1;
+        const fit_type z = _math_helper::sqrt(u);
+        return atan_reference(z) / z;
+    }
+
+    // octant kernels: cos(r) = P(r^2), sin(r) = r * Q(r^2) for |r| <= pi/4
+    constexpr fit_type octant_kernel_end = static_cast<fit_type>(M_PI * M_PI / 16);
+
+    /// \brief kernel polynomial from generated table if there is one, fitted otherwise
+    template<coefficient_table::kernel id, typename computation_type, std::size_t n, typename fit_function>
+    constexpr polynomial<computation_type, n> create_kernel_polynomial(const fit_function& fit)
+    {
+        using table = coefficient_table::generated<id, computation_type, n>;
+        if constexpr (table::available)
+            return polynomial<computation_type, n>(table::coefficients);
+        else
+            return fit();
+    }
+
     template<typename computation_type, std::size_t n>
     constexpr polynomial<computation_type, n> create_cos_polynomial()
     {
-        constexpr computation_type start = 0;
-        constexpr computation_type end = static_cast<computation_type>(M_PI*2);
-        constexpr computation_type step = (end - start) / (n-1);
+        return create_kernel_polynomial<coefficient_table::kernel::cos_octant, computation_type, n>([]
+        {
+            return polynomial<computation_type, n>::fit_minimax(cos_sqrt_reference, 0, octant_kernel_end);
+        });
+    }
 
-        typename polynomial<computation_type, n>::table_type table;
-        for(std::size_t i = 0; i < n; ++i)
+    template<typename computation_type, std::size_t n>
+    constexpr polynomial<computation_type, n> create_sin_polynomial()
+    {
+        return create_kernel_polynomial<coefficient_table::kernel::sin_octant, computation_type, n>([]
         {
-            const computation_type cur_param = start + step * i;
-            const computation_type cur_value = _math_helper::cos_tailor<computation_type, 10>(cur_param);
-            table[i] = std::make_pair(cur_param, cur_value);
-        }
+            return polynomial<computation_type, n>::fit_minimax(sin_sqrt_reference, 0, octant_kernel_end);
+        });
+    }
 
-        return polynomial<computation_type, n>::interpolate(table);
+    // atan(z) = z * R(z^2) for |z| <= 1, larger arguments use atan(z) = pi/2 - atan(1/z)
+    template<typename computation_type, std::size_t n>
+    constexpr polynomial<computation_type, n> create_atan_polynomial()
+    {
+        return create_kernel_polynomial<coefficient_table::kernel::atan_octant, computation_type, n>([]
+        {
+            return polynomial<computation_type, n>::fit_minimax(atan_sqrt_reference, 0, 1);
+        });
     }
 
     template<typename computation_type, std::size_t n>
     constexpr polynomial<computation_type, n> create_asin_polynomial()
     {
-        constexpr computation_type start = -1;
-        constexpr computation_type end = 1;
-        constexpr computation_type step = (end - start) / (n-1);
+        return create_kernel_polynomial<coefficient_table::kernel::asin, computation_type, n>([]
+        {
+            constexpr computation_type start = -1;
+            constexpr computation_type end = 1;
+            return polynomial<computation_type, n>::fit_minimax(asin_reference, start, end);
+        });
+    }
+
+    template<typename computation_type, std::size_t n, typename evaluation_policy>
+    inline constexpr polynomial<computation_type, n, evaluation_policy> cos_polynomial(
+        create_cos_polynomial<computation_type, n>().getCoefficients());
+
+    template<typename computation_type, std::size_t n, typename evaluation_policy>
+    inline constexpr polynomial<computation_type, n, evaluation_policy> sin_polynomial(
+        create_sin_polynomial<computation_type, n>().getCoefficients());
+
+    template<typename computation_type, std::size_t n, typename evaluation_policy>
+    inline constexpr polynomial<computation_type, n, evaluation_policy> atan_polynomial(
+        create_atan_polynomial<computation_type, n>().getCoefficients());
+
+    template<typename computation_type, std::size_t n, typename evaluation_policy>
+    inline constexpr polynomial<computation_type, n, evaluation_policy> asin_polynomial(
+        create_asin_polynomial<computation_type, n>().getCoefficients());
+
+    /// \brief sin and cos from octant kernel values of reduced argument
+    /// quadrant picks and negates them without branches
+    template<typename computation_type, typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr void sincos_from_octant(const value_type& quadrant, const value_type& octant_sin,
+        const value_type& octant_cos, value_type& sin, value_type& cos)
+    {
+        // quadrant: 0 -> ( s,  c), 1 -> ( c, -s), 2 -> (-s, -c), 3 -> (-c,  s)
+        // one comparison per condition: GCC turns combined range tests on one pack into scalar code
+        constexpr computation_type half = 0.5;
+        const auto swap = simd::abs(simd::abs(quadrant - 2) - 1) < half;
+        const value_type sin_abs = simd::select(swap, octant_cos, octant_sin);
+        const value_type cos_abs = simd::select(swap, octant_sin, octant_cos);
+        sin = simd::select(quadrant > 1 + half, -sin_abs, sin_abs);
+        cos = simd::select(simd::abs(quadrant - (1 + half)) < 1, -cos_abs, cos_abs);
+    }
+
+    /// \brief sin and cos of x from one quadrant reduction
+    /// both octant kernels are evaluated side by side; arguments 'range' keeps in [-pi/4, pi/4]
+    /// go to octant kernels without reduction
+    template<typename computation_type, std::size_t n, typename evaluation_policy, typename range = argument_range::unbounded,
+        typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr void sincos(const value_type& x, value_type& sin, value_type& cos)
+    {
+        if constexpr (argument_range::within<range>(M_PI_4))
+        {
+            const value_type x2 = x * x;
+            sin = x * sin_polynomial<computation_type, n, evaluation_policy>(x2);
+            cos = cos_polynomial<computation_type, n, evaluation_policy>(x2);
+        }
+        else
+        {
+            value_type r{};
+            value_type quadrant{};
+            reduce_quadrant<computation_type, range>(x, r, quadrant);
+
+            const value_type r2 = r * r;
+            const value_type octant_sin = r * sin_polynomial<computation_type, n, evaluation_policy>(r2);
+            const value_type octant_cos = cos_polynomial<computation_type, n, evaluation_policy>(r2);
+            sincos_from_octant<computation_type>(quadrant, octant_sin, octant_cos, sin, cos);
+        }
+    }
+
+    // batch kernels, 'apply' accepts scalars and simd packs, 'range' is argument contract of caller
+
+    template<typename computation_type, std::size_t n, typename evaluation_policy, typename range = argument_range::unbounded>
+    struct cos_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static value_type apply(const value_type& x)
+        {
+            value_type sin{};
+            value_type cos{};
+            sincos<computation_type, n, evaluation_policy, range>(x, sin, cos);
+            return cos;
+        }
+    };
+
+    template<typename computation_type, std::size_t n, typename evaluation_policy, typename range = argument_range::unbounded>
+    struct sin_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static value_type apply(const value_type& x)
+        {
+            value_type sin{};
+            value_type cos{};
+            sincos<computation_type, n, evaluation_policy, range>(x, sin, cos);
+            return sin;
+        }
+    };
+
+    template<typename computation_type, std::size_t n, typename evaluation_policy, typename range = argument_range::unbounded>
+    struct sincos_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static void apply(const value_type& x, value_type& sin, value_type& cos)
+        {
+            sincos<computation_type, n, evaluation_policy, range>(x, sin, cos);
+        }
+    };
+
+    template<typename computation_type, std::size_t n, typename evaluation_policy, typename range = argument_range::unbounded>
+    struct tan_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static value_type apply(const value_type& x)
+        {
+            value_type sin{};
+            value_type cos{};
+            sincos<computation_type, n, evaluation_policy, range>(x, sin, cos);
+            return sin / cos;
+        }
+    };
+
+    template<typename computation_type, std::size_t n, typename evaluation_policy, typename range = argument_range::unbounded>
+    struct asin_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static value_type apply(const value_type& x)
+        {
+            const value_type result = asin_polynomial<computation_type, n, evaluation_policy>(x);
+            if constexpr (argument_range::within<range>(1))
+                return result;
+            else
+            {
+                // outside [-1, 1] asin is NaN as std::asin, not polynomial extrapolation
+                const value_type nan = simd::broadcast<value_type>(std::numeric_limits<computation_type>::quiet_NaN());
+                return simd::select(simd::abs(x) <= 1, result, nan);
+            }
+        }
+    };
 
-        typename polynomial<computation_type, n>::table_type table;
-        for(std::size_t i = 0; i < n; ++i)
+    template<typename computation_type, std::size_t n, typename evaluation_policy, typename range = argument_range::unbounded>
+    struct acos_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static value_type apply(const value_type& x)
         {
-            const computation_type cur_param = start + step * i;
-            const computation_type cur_value = _math_helper::asin_tailor<computation_type, 10>(cur_param);
-            table[i] = std::make_pair(cur_param, cur_value);
+            constexpr computation_type pi_two = M_PI_2;
+            return pi_two - asin_kernel<computation_type, n, evaluation_policy, range>::apply(x);
         }
+    };
 
-        return polynomial<computation_type, n>::interpolate(table);
+    /// \brief atan of z with |z| <= 1 from octant polynomial
+    template<typename computation_type, std::size_t n, typename evaluation_policy, typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr value_type atan_octant(const value_type& z)
+    {
+        return z * atan_polynomial<computation_type, n, evaluation_policy>(z * z);
+    }
+
+    /// \brief argument of atan octant kernel, |x| > 1 uses atan(|x|) = pi/2 - atan(1/|x|)
+    template<typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr value_type atan_reduce(const value_type& x)
+    {
+        // divisor is kept nonzero for constant evaluation
+        const value_type a = simd::abs(x);
+        const auto reciprocal = a > 1;
+        const value_type one = simd::broadcast<value_type>(1);
+        return simd::select(reciprocal, one / simd::select(reciprocal, a, one), a);
+    }
+
+    /// \brief atan of x from octant kernel value at atan_reduce(x)
+    template<typename computation_type, typename value_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr value_type atan_from_octant(const value_type& x, const value_type& octant)
+    {
+        constexpr computation_type pi_two = M_PI_2;
+        const value_type result = simd::select(simd::abs(x) > 1, pi_two - octant, octant);
+        return simd::copysign(result, x);
     }
+
+    template<typename computation_type, std::size_t n, typename evaluation_policy, typename range = argument_range::unbounded>
+    struct atan_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static value_type apply(const value_type& x)
+        {
+            if constexpr (argument_range::within<range>(1))
+                return atan_octant<computation_type, n, evaluation_policy>(x);
+            else
+            {
+                const value_type z = atan_reduce(x);
+                return atan_from_octant<computation_type>(x, atan_octant<computation_type, n, evaluation_policy>(z));
+            }
+        }
+    };
+
+    template<typename computation_type, std::size_t n, typename evaluation_policy>
+    struct atan2_kernel
+    {
+        template<typename value_type>
+        TRIGONOMETRY_FORCE_INLINE constexpr static value_type apply(const value_type& rsin, const value_type& rcos)
+        {
+            constexpr computation_type pi = M_PI;
+            constexpr computation_type pi_two = M_PI_2;
+            const value_type y = simd::abs(rsin);
+            const value_type x = simd::abs(rcos);
+
+            // smaller over larger coordinate is in [0, 1], swap reflects angle over diagonal
+            const auto swap = y > x;
+            const value_type numerator = simd::select(swap, x, y);
+            const value_type denominator = simd::select(swap, y, x);
+            // 0 / 0 at origin becomes 0 / 1, so atan2(0, 0) = 0 as in std::atan2;
+            // infinite numerator means both coordinates are infinite, inf / inf becomes 1 (diagonal)
+            const value_type one = simd::broadcast<value_type>(1);
+            const value_type divisor = simd::select(denominator == 0, one, denominator);
+            const value_type z = simd::select(numerator == std::numeric_limits<computation_type>::infinity(), one, numerator / divisor);
+
+            const value_type octant = atan_octant<computation_type, n, evaluation_policy>(z);
+            const value_type half = simd::select(swap, pi_two - octant, octant);
+            // sign bit, not rcos < 0, so atan2(+-0, -0) = +-pi as in std::atan2
+            const value_type result = simd::select(simd::copysign(one, rcos) < 0, pi - half, half);
+            return simd::copysign(result, rsin);
+        }
+    };
 }
 
 
 
-template<typename computation_type, std::size_t polynomial_size>
+namespace _math_detail
+{
+#if defined(TRIGONOMETRY_SIMD)
+    /// one 16 byte register of computation_type, baseline of every x86-64 CPU
+    template<typename computation_type>
+    using scalar_pack = simd::pack<computation_type, 16 / sizeof(computation_type)>;
+#endif
+
+    /// \brief kernel::apply on scalar arguments as scalar_policy asks
+    template<typename kernel, typename scalar_policy, typename computation_type, typename... argument_types>
+    TRIGONOMETRY_FORCE_INLINE constexpr computation_type apply_scalar(argument_types... x)
+    {
+#if defined(TRIGONOMETRY_SIMD)
+        if constexpr (std::is_same_v<scalar_policy, scalar_evaluation::branchless>)
+        {
+            if (!std::is_constant_evaluated())
+                return simd::get_lane(kernel::apply(simd::broadcast<scalar_pack<computation_type>>(x)...), 0);
+        }
+#endif
+        return kernel::apply(x...);
+    }
+
+    /// \brief sin and cos of start + step * (first + i) for i in [0, count)
+    /// 'unroll' packs hold consecutive elements, each rotation step advances all of them by one block
+    /// of unroll * lanes elements; every anchor_interval steps packs restart from sincos_kernel at
+    /// exact angles. Tail and run<0> use scalar recurrence on element after element
+    template<typename computation_type, std::size_t n, typename evaluation_policy>
+    struct phase_kernel
+    {
+        constexpr static std::size_t unroll = 4;
+
+        template<std::size_t bytes>
+        TRIGONOMETRY_FORCE_INLINE static void run(computation_type start, computation_type step, std::size_t first, std::size_t count,
+            std::size_t anchor_interval, computation_type* sin, computation_type* cos)
+        {
+            using kernel = sincos_kernel<computation_type, n, evaluation_policy>;
+            std::size_t i = 0;
+#if defined(TRIGONOMETRY_SIMD)
+            if constexpr (bytes > 0)
+            {
+                constexpr std::size_t width = bytes / sizeof(computation_type);
+                constexpr std::size_t block = unroll * width;
+                using pack_type = simd::pack<computation_type, width>;
+
+                computation_type block_sin{};
+                computation_type block_cos{};
+                kernel::apply(step * static_cast<computation_type>(block), block_sin, block_cos);
+                const pack_type rotation_sin = simd::broadcast<pack_type>(block_sin);
+                const pack_type rotation_cos = simd::broadcast<pack_type>(block_cos);
+
+                while (i + block <= count)
+                {
+                    computation_type angles[block];
+                    for (std::size_t e = 0; e < block; ++e)
+                        angles[e] = start + step * static_cast<computation_type>(first + i + e);
+                    std::array<pack_type, unroll> sin_packs{};
+                    std::array<pack_type, unroll> cos_packs{};
+                    for (std::size_t u = 0; u < unroll; ++u)
+                        kernel::apply(pack_type::load(angles + u * width), sin_packs[u], cos_packs[u]);
+
+                    for (std::size_t steps = 0; steps < anchor_interval && i + block <= count; ++steps, i += block)
+                    {
+                        for (std::size_t u = 0; u < unroll; ++u)
+                        {
+                            sin_packs[u].store(sin + i + u * width);
+                            cos_packs[u].store(cos + i + u * width);
+                            const pack_type rotated_sin = sin_packs[u] * rotation_cos + cos_packs[u] * rotation_sin;
+                            cos_packs[u] = cos_packs[u] * rotation_cos - sin_packs[u] * rotation_sin;
+                            sin_packs[u] = rotated_sin;
+                        }
+                    }
+                }
+            }
+#endif
+            computation_type step_sin{};
+            computation_type step_cos{};
+            kernel::apply(step, step_sin, step_cos);
+            computation_type current_sin{};
+            computation_type current_cos{};
+            for (std::size_t since_anchor = anchor_interval; i < count; ++i, ++since_anchor)
+            {
+                if (since_anchor == anchor_interval)
+                {
+                    kernel::apply(start + step * static_cast<computation_type>(first + i), current_sin, current_cos);
+                    since_anchor = 0;
+                }
+                sin[i] = current_sin;
+                cos[i] = current_cos;
+                const computation_type rotated_sin = current_sin * step_cos + current_cos * step_sin;
+                current_cos = current_cos * step_cos - current_sin * step_sin;
+                current_sin = rotated_sin;
+            }
+        }
+    };
+
+    /// \brief kernel::apply(x, first, second) on scalars as scalar_policy asks
+    template<typename kernel, typename scalar_policy, typename computation_type>
+    TRIGONOMETRY_FORCE_INLINE constexpr void apply_scalar_pair(computation_type x, computation_type& first, computation_type& second)
+    {
+#if defined(TRIGONOMETRY_SIMD)
+        if constexpr (std::is_same_v<scalar_policy, scalar_evaluation::branchless>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                using pack_type = scalar_pack<computation_type>;
+                pack_type first_pack{};
+                pack_type second_pack{};
+                kernel::apply(simd::broadcast<pack_type>(x), first_pack, second_pack);
+                first = simd::get_lane(first_pack, 0);
+                second = simd::get_lane(second_pack, 0);
+                return;
+            }
+        }
+#endif
+        kernel::apply(x, first, second);
+    }
+}
+
+/// \brief trigonometric functions approximated by polynomials with 'polynomial_size' coefficients
+/// sin/cos reduce argument to [-pi/4, pi/4] and evaluate even kernels in r^2, so their
+/// degree in r is 2*polynomial_size-1 for sin and 2*polynomial_size-2 for cos.
+/// 'evaluation_policy' sets polynomial evaluation order, see polynomial_evaluation.
+/// 'storage_type' is element type of batch arrays, e.g. simd::float16 or simd::bfloat16
+/// with float computation halves memory traffic of bandwidth bound batches.
+/// 'scalar_policy' sets how scalar calls evaluate, see scalar_evaluation.
+/// 'result_storage_type' is element type of batch results, e.g. float results of simd::float16 arguments.
+/// Functions but atan2 take an argument contract, e.g. cos<argument_range::octant>(x), that drops
+/// reduction steps the range does not need; contracts are asserted in debug builds, see argument_range
+template<typename computation_type, std::size_t polynomial_size, typename evaluation_policy = polynomial_evaluation::horner,
+    typename storage_type = computation_type, typename scalar_policy = scalar_evaluation::branching, typename result_storage_type = storage_type>
 struct trigonometry
 {
+    template<typename range = argument_range::unbounded>
     constexpr static computation_type cos(computation_type x)
     {
-        constexpr auto polynomial_interpolation = _math_detail::create_cos_polynomial<computation_type, polynomial_size>();
-        constexpr computation_type min = 0;
-        constexpr computation_type max = static_cast<computation_type>(M_PI*2);
-        constexpr computation_type period = static_cast<computation_type>(M_PI*2);
-        if (x < min)
-            x -= (static_cast<int>(x / period) -1) * period;
-        else if (x > max)
-            x -= static_cast<int>(x / period) * period;
-        return polynomial_interpolation(x);
+        assert(argument_range::contains<range>(x));
+        instrumentation::record(instrumentation::function::cos, x);
+        return _math_detail::apply_scalar<_math_detail::cos_kernel<computation_type, polynomial_size, evaluation_policy, range>, scalar_policy, computation_type>(x);
     }
 
+    template<typename range = argument_range::unbounded>
     constexpr static computation_type sin(computation_type x)
     {
-        constexpr computation_type theta = M_PI_2;
-        return cos(theta - x);
+        assert(argument_range::contains<range>(x));
+        instrumentation::record(instrumentation::function::sin, x);
+        return _math_detail::apply_scalar<_math_detail::sin_kernel<computation_type, polynomial_size, evaluation_policy, range>, scalar_policy, computation_type>(x);
+    }
+
+    /// \brief sin and cos of x sharing one range reduction, both kernels evaluated side by side
+    template<typename range = argument_range::unbounded>
+    constexpr static void sincos(computation_type x, computation_type* sin, computation_type* cos)
+    {
+        assert(argument_range::contains<range>(x));
+        instrumentation::record(instrumentation::function::sincos, x);
+        _math_detail::apply_scalar_pair<_math_detail::sincos_kernel<computation_type, polynomial_size, evaluation_policy, range>, scalar_policy>(x, *sin, *cos);
     }
 
+    template<typename range = argument_range::unbounded>
     constexpr static computation_type tan(computation_type x)
     {
-        const auto _sin = sin(x);
-        const auto _cos = cos(x);
-        return _sin / _cos;
+        assert(argument_range::contains<range>(x));
+        instrumentation::record(instrumentation::function::tan, x);
+        return _math_detail::apply_scalar<_math_detail::tan_kernel<computation_type, polynomial_size, evaluation_policy, range>, scalar_policy, computation_type>(x);
     }
 
+    /// \brief NaN outside [-1, 1] unless 'range' promises arguments in it
+    template<typename range = argument_range::unbounded>
     constexpr static computation_type asin(computation_type x)
     {
-        constexpr auto polynomial_interpolation = _math_detail::create_asin_polynomial<computation_type, polynomial_size>();
-        return polynomial_interpolation(x);
+        assert(argument_range::contains<range>(x));
+        instrumentation::record(instrumentation::function::asin, x);
+        return _math_detail::apply_scalar<_math_detail::asin_kernel<computation_type, polynomial_size, evaluation_policy, range>, scalar_policy, computation_type>(x);
     }
 
+    template<typename range = argument_range::unbounded>
     constexpr static computation_type acos(computation_type x)
     {
-        constexpr computation_type pi_two = M_PI_2;
-        return pi_two - asin(x);
+        assert(argument_range::contains<range>(x));
+        instrumentation::record(instrumentation::function::acos, x);
+        return _math_detail::apply_scalar<_math_detail::acos_kernel<computation_type, polynomial_size, evaluation_policy, range>, scalar_policy, computation_type>(x);
     }
     
-    //constexpr static computation_type atan(computation_type x)
-    //{
-    //    return asin(x / _math_helper::sqrt<computation_type>(1 + x*x));
-    //}
+    template<typename range = argument_range::unbounded>
+    constexpr static computation_type atan(computation_type x)
+    {
+        assert(argument_range::contains<range>(x));
+        instrumentation::record(instrumentation::function::atan, x);
+        return _math_detail::apply_scalar<_math_detail::atan_kernel<computation_type, polynomial_size, evaluation_policy, range>, scalar_policy, computation_type>(x);
+    }
 
     constexpr static computation_type atan2(computation_type rsin, computation_type rcos)
     {
-        const computation_type r = _math_helper::sqrt<computation_type>(rcos*rcos + rsin*rsin);
-        const computation_type _asin = asin(rsin / r);
+        instrumentation::record(instrumentation::function::atan2, rsin, rcos);
+        return _math_detail::apply_scalar<_math_detail::atan2_kernel<computation_type, polynomial_size, evaluation_policy>, scalar_policy, computation_type>(rsin, rcos);
+    }
+
+    /// \brief batch versions
+    /// result[i] = f(x[i]); result must be at least as long as x, may alias x when both storage types are same.
+    /// Evaluated by simd kernels of widest instruction set running CPU supports,
+    /// arrays of storage_type and result_storage_type are converted from and to computation_type in registers
+    template<typename range = argument_range::unbounded>
+    static void cos(std::span<const storage_type> x, std::span<result_storage_type> result)
+    {
+        assert(result.size() >= x.size());
+        assert((argument_range::contains_all<range, computation_type>(x)));
+        instrumentation::record_batch<computation_type>(instrumentation::function::cos, x);
+        simd::transform<_math_detail::cos_kernel<computation_type, polynomial_size, evaluation_policy, range>, computation_type>(x.size(), result.data(), x.data());
+    }
+
+    template<typename range = argument_range::unbounded>
+    static void sin(std::span<const storage_type> x, std::span<result_storage_type> result)
+    {
+        assert(result.size() >= x.size());
+        assert((argument_range::contains_all<range, computation_type>(x)));
+        instrumentation::record_batch<computation_type>(instrumentation::function::sin, x);
+        simd::transform<_math_detail::sin_kernel<computation_type, polynomial_size, evaluation_policy, range>, computation_type>(x.size(), result.data(), x.data());
+    }
+
+    /// sin may alias x, sin and cos must not alias each other
+    template<typename range = argument_range::unbounded>
+    static void sincos(std::span<const storage_type> x, std::span<result_storage_type> sin, std::span<result_storage_type> cos)
+    {
+        assert(sin.size() >= x.size() && cos.size() >= x.size());
+        assert((argument_range::contains_all<range, computation_type>(x)));
+        instrumentation::record_batch<computation_type>(instrumentation::function::sincos, x);
+        simd::transform_pair<_math_detail::sincos_kernel<computation_type, polynomial_size, evaluation_policy, range>, computation_type>(x.size(), sin.data(), cos.data(), x.data());
+    }
+
+    template<typename range = argument_range::unbounded>
+    static void tan(std::span<const storage_type> x, std::span<result_storage_type> result)
+    {
+        assert(result.size() >= x.size());
+        assert((argument_range::contains_all<range, computation_type>(x)));
+        instrumentation::record_batch<computation_type>(instrumentation::function::tan, x);
+        simd::transform<_math_detail::tan_kernel<computation_type, polynomial_size, evaluation_policy, range>, computation_type>(x.size(), result.data(), x.data());
+    }
+
+    template<typename range = argument_range::unbounded>
+    static void asin(std::span<const storage_type> x, std::span<result_storage_type> result)
+    {
+        assert(result.size() >= x.size());
+        assert((argument_range::contains_all<range, computation_type>(x)));
+        instrumentation::record_batch<computation_type>(instrumentation::function::asin, x);
+        simd::transform<_math_detail::asin_kernel<computation_type, polynomial_size, evaluation_policy, range>, computation_type>(x.size(), result.data(), x.data());
+    }
+
+    template<typename range = argument_range::unbounded>
+    static void acos(std::span<const storage_type> x, std::span<result_storage_type> result)
+    {
+        assert(result.size() >= x.size());
+        assert((argument_range::contains_all<range, computation_type>(x)));
+        instrumentation::record_batch<computation_type>(instrumentation::function::acos, x);
+        simd::transform<_math_detail::acos_kernel<computation_type, polynomial_size, evaluation_policy, range>, computation_type>(x.size(), result.data(), x.data());
+    }
+
+    template<typename range = argument_range::unbounded>
+    static void atan(std::span<const storage_type> x, std::span<result_storage_type> result)
+    {
+        assert(result.size() >= x.size());
+        assert((argument_range::contains_all<range, computation_type>(x)));
+        instrumentation::record_batch<computation_type>(instrumentation::function::atan, x);
+        simd::transform<_math_detail::atan_kernel<computation_type, polynomial_size, evaluation_policy, range>, computation_type>(x.size(), result.data(), x.data());
+    }
+
+    static void atan2(std::span<const storage_type> rsin, std::span<const storage_type> rcos, std::span<result_storage_type> result)
+    {
+        assert(rcos.size() == rsin.size() && result.size() >= rsin.size());
+        instrumentation::record_batch<computation_type>(instrumentation::function::atan2, rsin, rcos);
+        simd::transform<_math_detail::atan2_kernel<computation_type, polynomial_size, evaluation_policy>, computation_type>(rsin.size(), result.data(), rsin.data(), rcos.data());
+    }
+
+    /// \brief parallel batch versions, same contracts and argument ranges as batch versions
+    /// arrays are split into chunks sized to L2 cache (parallel::chunk_size), every thread of pool
+    /// runs batch kernels on its chunks. Overloads taking std::execution::par_unseq use parallel::default_thread_pool
+    template<typename range = argument_range::unbounded>
+    static void cos(parallel::thread_pool& pool, std::span<const storage_type> x, std::span<result_storage_type> result)
+    {
+        parallel_transform<_math_detail::cos_kernel<computation_type, polynomial_size, evaluation_policy, range>, range>(pool, instrumentation::function::cos, x, result);
+    }
+
+    template<typename range = argument_range::unbounded>
+    static void sin(parallel::thread_pool& pool, std::span<const storage_type> x, std::span<result_storage_type> result)
+    {
+        parallel_transform<_math_detail::sin_kernel<computation_type, polynomial_size, evaluation_policy, range>, range>(pool, instrumentation::function::sin, x, result);
+    }
+
+    template<typename range = argument_range::unbounded>
+    static void sincos(parallel::thread_pool& pool, std::span<const storage_type> x, std::span<result_storage_type> sin, std::span<result_storage_type> cos)
+    {
+        assert(sin.size() >= x.size() && cos.size() >= x.size());
+        instrumentation::record_batch_call(instrumentation::function::sincos);
+        pool.for_each_chunk(x.size(), parallel::chunk_size<chunk_element_type>(3), [&](std::size_t begin, std::size_t end)
+        {
+            const std::span<const storage_type> chunk = x.subspan(begin, end - begin);
+            assert((argument_range::contains_all<range, computation_type>(chunk)));
+            instrumentation::record_elements<computation_type>(instrumentation::function::sincos, chunk);
+            simd::transform_pair<_math_detail::sincos_kernel<computation_type, polynomial_size, evaluation_policy, range>, computation_type>(
+                chunk.size(), sin.data() + begin, cos.data() + begin, chunk.data());
+        });
+    }
+
+    template<typename range = argument_range::unbounded>
+    static void tan(parallel::thread_pool& pool, std::span<const storage_type> x, std::span<result_storage_type> result)
+    {
+        parallel_transform<_math_detail::tan_kernel<computation_type, polynomial_size, evaluation_policy, range>, range>(pool, instrumentation::function::tan, x, result);
+    }
+
+    template<typename range = argument_range::unbounded>
+    static void asin(parallel::thread_pool& pool, std::span<const storage_type> x, std::span<result_storage_type> result)
+    {
+        parallel_transform<_math_detail::asin_kernel<computation_type, polynomial_size, evaluation_policy, range>, range>(pool, instrumentation::function::asin, x, result);
+    }
+
+    template<typename range = argument_range::unbounded>
+    static void acos(parallel::thread_pool& pool, std::span<const storage_type> x, std::span<result_storage_type> result)
+    {
+        parallel_transform<_math_detail::acos_kernel<computation_type, polynomial_size, evaluation_policy, range>, range>(pool, instrumentation::function::acos, x, result);
+    }
+
+    template<typename range = argument_range::unbounded>
+    static void atan(parallel::thread_pool& pool, std::span<const storage_type> x, std::span<result_storage_type> result)
+    {
+        parallel_transform<_math_detail::atan_kernel<computation_type, polynomial_size, evaluation_policy, range>, range>(pool, instrumentation::function::atan, x, result);
+    }
+
+    static void atan2(parallel::thread_pool& pool, std::span<const storage_type> rsin, std::span<const storage_type> rcos, std::span<result_storage_type> result)
+    {
+        assert(rcos.size() == rsin.size() && result.size() >= rsin.size());
+        instrumentation::record_batch_call(instrumentation::function::atan2);
+        pool.for_each_chunk(rsin.size(), parallel::chunk_size<chunk_element_type>(3), [&](std::size_t begin, std::size_t end)
+        {
+            const std::span<const storage_type> sin_chunk = rsin.subspan(begin, end - begin);
+            const std::span<const storage_type> cos_chunk = rcos.subspan(begin, end - begin);
+            instrumentation::record_elements<computation_type>(instrumentation::function::atan2, sin_chunk, cos_chunk);
+            simd::transform<_math_detail::atan2_kernel<computation_type, polynomial_size, evaluation_policy>, computation_type>(
+                sin_chunk.size(), result.data() + begin, sin_chunk.data(), cos_chunk.data());
+        });
+    }
+
+#if defined(TRIGONOMETRY_EXECUTION_POLICIES)
+    using parallel_policy = std::execution::parallel_unsequenced_policy;
+
+    template<typename range = argument_range::unbounded>
+    static void cos(const parallel_policy&, std::span<const storage_type> x, std::span<result_storage_type> result) { cos<range>(parallel::default_thread_pool(), x, result); }
+    template<typename range = argument_range::unbounded>
+    static void sin(const parallel_policy&, std::span<const storage_type> x, std::span<result_storage_type> result) { sin<range>(parallel::default_thread_pool(), x, result); }
+    template<typename range = argument_range::unbounded>
+    static void sincos(const parallel_policy&, std::span<const storage_type> x, std::span<result_storage_type> sin, std::span<result_storage_type> cos) { sincos<range>(parallel::default_thread_pool(), x, sin, cos); }
+    template<typename range = argument_range::unbounded>
+    static void tan(const parallel_policy&, std::span<const storage_type> x, std::span<result_storage_type> result) { tan<range>(parallel::default_thread_pool(), x, result); }
+    template<typename range = argument_range::unbounded>
+    static void asin(const parallel_policy&, std::span<const storage_type> x, std::span<result_storage_type> result) { asin<range>(parallel::default_thread_pool(), x, result); }
+    template<typename range = argument_range::unbounded>
+    static void acos(const parallel_policy&, std::span<const storage_type> x, std::span<result_storage_type> result) { acos<range>(parallel::default_thread_pool(), x, result); }
+    template<typename range = argument_range::unbounded>
+    static void atan(const parallel_policy&, std::span<const storage_type> x, std::span<result_storage_type> result) { atan<range>(parallel::default_thread_pool(), x, result); }
+    static void atan2(const parallel_policy&, std::span<const storage_type> rsin, std::span<const storage_type> rcos, std::span<result_storage_type> result) { atan2(parallel::default_thread_pool(), rsin, rcos, result); }
+#endif
 
-        if(rcos >= 0)
-            return _asin;
-        
-        if(rsin > 0)
-            return static_cast<computation_type>(M_PI) - _asin;
-        return -static_cast<computation_type>(M_PI) - _asin;
+private:
+    /// wider of storage types, so chunks of every stream fit into cache
+    using chunk_element_type = std::conditional_t<(sizeof(result_storage_type) > sizeof(storage_type)), result_storage_type, storage_type>;
+
+    /// one batch call is recorded for whole array, elements are recorded and contract is asserted by chunks on their threads
+    template<typename kernel, typename range>
+    static void parallel_transform(parallel::thread_pool& pool, instrumentation::function id, std::span<const storage_type> x, std::span<result_storage_type> result)
+    {
+        assert(result.size() >= x.size());
+        instrumentation::record_batch_call(id);
+        pool.for_each_chunk(x.size(), parallel::chunk_size<chunk_element_type>(2), [&](std::size_t begin, std::size_t end)
+        {
+            const std::span<const storage_type> chunk = x.subspan(begin, end - begin);
+            assert((argument_range::contains_all<range, computation_type>(chunk)));
+            instrumentation::record_elements<computation_type>(id, chunk);
+            simd::transform<kernel, computation_type>(chunk.size(), result.data() + begin, chunk.data());
+        });
     }
-};
\ No newline at end of file
+};
+
+/// \brief sin and cos of arithmetic angle progression start + step * i, e.g. oscillators and FFT twiddles
+/// Elements follow by rotation recurrence (sin, cos) <- (sin cos(d) + cos sin(d), cos cos(d) - sin sin(d)),
+/// two multiply-adds each instead of range reduction and polynomials. Every 'anchor_interval' rotations
+/// values restart from sincos polynomial at exact angle start + step * i, which bounds drift of recurrence.
+/// generate interleaves simd packs of consecutive elements, so one rotation advances a block of
+/// 4 * lanes elements by 4 * lanes * step
+template<typename computation_type, std::size_t polynomial_size, typename evaluation_policy = polynomial_evaluation::horner>
+class phase_sequence {
+public:
+    /// rotations between anchors; drift of 16 rotations stays below error of batch sincos for float and double
+    constexpr static std::size_t default_anchor_interval = 16;
+
+    constexpr phase_sequence(computation_type start, computation_type step, std::size_t anchor_interval = default_anchor_interval) :
+        mStart(start),
+        mStep(step),
+        mAnchorInterval(anchor_interval),
+        mSinceAnchor(anchor_interval)
+    {
+        assert(anchor_interval > 0);
+        kernel::apply(step, mStepSin, mStepCos);
+    }
+
+    /// \brief index of next element
+    constexpr std::size_t position() const { return mPosition; }
+
+    /// \brief continues from element 'index'
+    constexpr void seek(std::size_t index)
+    {
+        mPosition = index;
+        mSinceAnchor = mAnchorInterval;
+    }
+
+    /// \brief sin and cos of next element by scalar recurrence, e.g. one oscillator sample per call
+    constexpr void next(computation_type* sin, computation_type* cos)
+    {
+        if (mSinceAnchor == mAnchorInterval)
+        {
+            kernel::apply(mStart + mStep * static_cast<computation_type>(mPosition), mSin, mCos);
+            mSinceAnchor = 0;
+        }
+        *sin = mSin;
+        *cos = mCos;
+        const computation_type rotated_sin = mSin * mStepCos + mCos * mStepSin;
+        mCos = mCos * mStepCos - mSin * mStepSin;
+        mSin = rotated_sin;
+        ++mSinceAnchor;
+        ++mPosition;
+    }
+
+    /// \brief sin and cos of next sin.size() elements by simd kernels of widest instruction set
+    /// running CPU supports; every call anchors at its first element, so long spans pay off most.
+    /// sin and cos must not alias each other
+    void generate(std::span<computation_type> sin, std::span<computation_type> cos)
+    {
+        assert(cos.size() >= sin.size());
+        simd::dispatch<_math_detail::phase_kernel<computation_type, polynomial_size, evaluation_policy>>(
+            mStart, mStep, mPosition, sin.size(), mAnchorInterval, sin.data(), cos.data());
+        seek(mPosition + sin.size());
+    }
+
+private:
+    using kernel = _math_detail::sincos_kernel<computation_type, polynomial_size, evaluation_policy>;
+
+    computation_type mStart;
+    computation_type mStep;
+    computation_type mStepSin{};
+    computation_type mStepCos{};
+    computation_type mSin{};
+    computation_type mCos{};
+    std::size_t mAnchorInterval;
+    std::size_t mSinceAnchor;
+    std::size_t mPosition = 0;
+};
@@ -16,5 +16,6 @@ int main()
 
     std::cout<<"asin(0): "<<math::asin(0)<<std::endl;
     std::cout<<"acos(0): "<<math::acos(0)<<std::endl;
+    std::cout<<"atan(1): "<<math::atan(1)<<std::endl;
     std::cout<<"atan2(1, 0): "<<math::atan2(1,0)<<std::endl;
 }
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "coefficient_table.h"
+#include "polynomial_engine.h"
+#include "trigonometry.h"
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+
+namespace
+{
+    using fit_type = polynomial_fit_detail::fit_type;
+    using coefficient_table::kernel;
+
+    constexpr std::size_t sample_count = 1 << 14;
+
+    const char* kernel_name(kernel id)
+    {
+        switch (id)
+        {
+        case kernel::sin_octant: return "sin_octant";
+        case kernel::cos_octant: return "cos_octant";
+        case kernel::asin: return "asin";
+        default: return "atan_octant";
+        }
+    }
+
+    template<typename type>
+    const char* type_name()
+    {
+        return sizeof(type) == sizeof(float) ? "float" : "double";
+    }
+
+    template<typename type, std::size_t size>
+    polynomial<type, size> create(kernel id)
+    {
+        switch (id)
+        {
+        case kernel::sin_octant: return _math_detail::create_sin_polynomial<type, size>();
+        case kernel::cos_octant: return _math_detail::create_cos_polynomial<type, size>();
+        case kernel::asin: return _math_detail::create_asin_polynomial<type, size>();
+        default: return _math_detail::create_atan_polynomial<type, size>();
+        }
+    }
+
+    /// \brief max |p(x) - f(x)| on kernel domain, coefficients rounded to 'type', evaluation in fit_type
+    template<typename type, std::size_t size>
+    fit_type max_error(kernel id, const polynomial<type, size>& p)
+    {
+        fit_type min = 0;
+        fit_type max = 1;
+        fit_type (*reference)(fit_type) = _math_detail::atan_sqrt_reference;
+        switch (id)
+        {
+        case kernel::sin_octant: reference = _math_detail::sin_sqrt_reference; max = _math_detail::octant_kernel_end; break;
+        case kernel::cos_octant: reference = _math_detail::cos_sqrt_reference; max = _math_detail::octant_kernel_end; break;
+        case kernel::asin: reference = _math_detail::asin_reference; min = -1; break;
+        default: break;
+        }
+
+        fit_type error = 0;
+        for (std::size_t k = 0; k <= sample_count; ++k)
+        {
+            const fit_type x = min + (max - min) * k / sample_count;
+            fit_type value = p.getCoefficients()[size-1];
+            for (std::size_t j = size-1; j-- > 0;)
+                value = value * x + static_cast<fit_type>(p.getCoefficients()[j]);
+            error = std::max(error, std::fabs(value - reference(x)));
+        }
+        return error;
+    }
+
+    /// \brief one specialization of coefficient_table::generated, coefficients in exact hexadecimal
+    template<typename type, std::size_t size>
+    void write_specialization(kernel id, const polynomial<type, size>& p, fit_type error, std::ostream& o_header)
+    {
+        o_header<<"    template<>\n    struct generated<kernel::"<<kernel_name(id)<<", "<<type_name<type>()<<", "<<size<<">\n    {\n"
+            <<"        constexpr static bool available = true;\n"
+            <<"        constexpr static long double max_error = "<<std::scientific<<std::setprecision(6)<<static_cast<double>(error)<<"l;\n"
+            <<"        constexpr static std::array<"<<type_name<type>()<<", "<<size<<"> coefficients = {";
+        for (std::size_t i = 0; i < size; ++i)
+            o_header<<(i == 0 ? "" : ",")<<"\n            "<<std::hexfloat<<static_cast<double>(p.getCoefficients()[i])<<(sizeof(type) == sizeof(float) ? "f" : "");
+        o_header<<std::defaultfloat<<"};\n    };\n\n";
+    }
+
+    template<typename type, std::size_t... sizes>
+    void generate(std::index_sequence<sizes...>, coefficient_table::builder& o_table, std::ostream& o_header)
+    {
+        for (std::size_t id = 0; id < coefficient_table::kernel_count; ++id)
+        {
+            ([&]
+            {
+                const polynomial<type, sizes> p = create<type, sizes>(static_cast<kernel>(id));
+                const fit_type error = max_error(static_cast<kernel>(id), p);
+                o_table.add<type>(static_cast<kernel>(id), p.getCoefficients(), static_cast<double>(error));
+                write_specialization(static_cast<kernel>(id), p, error, o_header);
+                std::cout<<std::left<<std::setw(12)<<kernel_name(static_cast<kernel>(id))<<std::setw(8)<<type_name<type>()
+                    <<std::setw(6)<<sizes<<std::scientific<<std::setprecision(3)<<static_cast<double>(error)<<std::defaultfloat<<std::endl;
+            }(), ...);
+        }
+    }
+
+    /// sizes min_size ... max_size of polynomial_engine
+    template<std::size_t... offsets>
+    constexpr auto engine_sizes(std::index_sequence<offsets...>)
+    {
+        return std::index_sequence<_engine_detail::min_size + offsets...>();
+    }
+}
+
+/// \brief fits every kernel polynomial of trigonometry and polynomial_engine for float and double,
+/// sizes polynomial_engine::min_size ... max_size, and writes trigonometry_tables.h and
+/// trigonometry_tables.bin into directory given by first argument (default: working directory)
+int main(int argc, char** argv)
+{
+    const std::string directory = argc > 1 ? argv[1] : ".";
+    constexpr auto sizes = engine_sizes(std::make_index_sequence<_engine_detail::max_size - _engine_detail::min_size + 1>());
+
+    std::ofstream header(directory + "/trigonometry_tables.h");
+    header<<"// generated by table_generator, do not edit\n#pragma once\n\n#include \"coefficient_table.h\"\n\n"
+        <<"namespace coefficient_table\n{\n";
+    coefficient_table::builder table;
+    generate<float>(sizes, table, header);
+    generate<double>(sizes, table, header);
+    header<<"}\n";
+
+    std::ofstream binary(directory + "/trigonometry_tables.bin", std::ios::binary);
+    table.write(binary);
+
+    if (!header || !binary)
+    {
+        std::cerr<<"cannot write tables into "<<directory<<std::endl;
+        return 1;
+    }
+    return 0;
+}